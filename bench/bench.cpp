@@ -0,0 +1,282 @@
+// Microbenchmarks of the per-entity kernels a GAME tick runs (make bench).
+//   --out FILE       write results as JSON
+//   --baseline FILE  compare against an earlier --out file; exits 1 on a regression
+//                    (fastest repeats are compared, they are the least disturbed by noise)
+//   --tolerance PCT  slowdown allowed before a kernel counts as regressed (default 10)
+//   --filter TEXT    only run kernels whose name contains TEXT
+#include "../src/entities.h"
+#include "../src/quality.h"
+#include "../src/archetypes.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BENCH_REPEATS 7
+#define BENCH_MIN_SECONDS 0.02
+
+struct BenchResult {
+    const char* name;
+    int items;          // entities one op touches
+    double nsPerOp;     // median over the repeats
+    double minNsPerOp;
+};
+
+static volatile float sink; // keeps results alive past the optimizer
+
+static double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float Rand01() { return (float)rand() / RAND_MAX; }
+
+// Times op() in batches big enough to read the clock reliably; median of the repeats
+template <typename Op>
+static BenchResult Measure(const char* name, int items, Op op) {
+    long long iters = 1;
+    for (;;) {
+        double t0 = Now();
+        for (long long i = 0; i < iters; i++) op();
+        if (Now() - t0 >= BENCH_MIN_SECONDS) break;
+        iters *= 2;
+    }
+    double samples[BENCH_REPEATS];
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double t0 = Now();
+        for (long long i = 0; i < iters; i++) op();
+        samples[r] = (Now() - t0) * 1e9 / iters;
+    }
+    std::sort(samples, samples + BENCH_REPEATS);
+    return { name, items, samples[BENCH_REPEATS / 2], samples[0] };
+}
+
+// ------------ Kernels --------------
+static BenchResult BenchAabb() {
+    const int n = 4096;
+    std::vector<Rectangle> rects(n);
+    for (auto& r : rects) r = { Rand01() * SCREEN_WIDTH * 2, Rand01() * SCREEN_HEIGHT, 60, 60 };
+    Rectangle player = { 250, 500, 90, 140 };
+    return Measure("aabb_rects", n, [&]() {
+        int hits = 0;
+        for (const auto& r : rects) hits += CheckCollisionRecs(player, r);
+        player.x = player.x > SCREEN_WIDTH ? 0.0f : player.x + 7.0f;
+        sink = (float)hits;
+    });
+}
+
+static BenchResult BenchPlacement() {
+    const int n = 1024;
+    std::vector<Coin> coins(n);
+    for (auto& c : coins) { c.position = { Rand01() * SCREEN_WIDTH * 10, 500 + Rand01() * 100 }; c.active = true; c.prevPosition = c.position; }
+    std::vector<Rock> rocks(MAX_ROCKS);
+    for (auto& r : rocks) { r.position = { Rand01() * SCREEN_WIDTH * 2, 665 }; r.active = true; r.prevPosition = r.position; }
+    float x = 0.0f;
+    return Measure("placement_scan", n + MAX_ROCKS, [&]() {
+        // A candidate coin spot tested the way a respawn does: rocks first, then the other coins
+        Rectangle area = { x, 560, 30, 30 };
+        bool blocked = OverlapsAnyActive(rocks, area, { 110, 110 }, { 50, 50 })
+            || OverlapsAnyActive(coins, area, { 30, 30 }, { 32, 40 }, &coins[0]);
+        x = x > SCREEN_WIDTH * 10 ? 0.0f : x + 97.0f;
+        sink = blocked;
+    });
+}
+
+static BenchResult BenchMagnet() {
+    const int n = 4096;
+    std::vector<Coin> coins(n);
+    for (auto& c : coins) { c.position = { Rand01() * 800, 400 + Rand01() * 300 }; c.active = true; }
+    std::vector<Coin> start = coins;
+    int steps = 0;
+    return Measure("magnet_pull", n, [&]() {
+        for (auto& c : coins) MagnetPull(c.position, { 15, 15 }, { 295, 570 }, 300.0f, 5.0f);
+        if (++steps == 60) { coins = start; steps = 0; } // keep coins inside the radius
+        sink = coins[n / 2].position.x;
+    });
+}
+
+static BenchResult BenchRushPull() {
+    const int n = 5000;
+    alignas(16) static float x[n + 4], y[n + 4], startX[n], startY[n];
+    static int gone[n];
+    static Vector2 pickedAt[n];
+    for (int i = 0; i < n; i++) { startX[i] = x[i] = Rand01() * SCREEN_WIDTH * 1.3f; startY[i] = y[i] = 60 + Rand01() * 560; }
+    int steps = 0;
+    // One op: a coin rush tick's pull, scroll and pickup test over the whole field
+    return Measure("rush_pull", n, [&]() {
+        int picked;
+        int goneCount = PullCoinField(x, y, n, { 295, 570 }, 15.0f, 7.0f, 60.0f, -40.0f, gone, pickedAt, &picked);
+        for (int g = 0; g < goneCount; g++) { x[gone[g]] = startX[gone[g]]; y[gone[g]] = startY[gone[g]]; } // as the top-up does
+        if (++steps == 60) { memcpy(x, startX, sizeof(startX)); memcpy(y, startY, sizeof(startY)); steps = 0; }
+        sink = (float)goneCount + x[n / 2];
+    });
+}
+
+static BenchResult BenchCoinStep() {
+    const int n = 4096;
+    std::vector<Coin> coins(n);
+    for (auto& c : coins) { c.position = { Rand01() * SCREEN_WIDTH * 4, 500 + Rand01() * 130 }; c.active = true; c.prevPosition = c.position; }
+    std::vector<Coin> start = coins;
+    ArchetypeSize size = SizeArchetype(ARCH_COIN, 64, 64, 90, 140);
+    PlayerTick player = { nullptr, { 250, 500, 90, 140 }, { 0, -4 }, { 295, 570 }, true, 400.0f, 5.0f };
+    ArchetypeHit hits[MAX_TICK_HITS];
+    int steps = 0;
+    // One op: the coin archetype's tick (magnet pull, scroll, swept pickup test)
+    return Measure("coin_step", n, [&]() {
+        for (auto& c : coins) c.prevPosition = c.position;
+        int picked = StepArchetype<ARCH_COIN>(coins, size, nullptr, player, 7.0f, hits, MAX_TICK_HITS);
+        if (++steps == 60) { coins = start; steps = 0; }
+        sink = (float)picked + coins[n / 2].position.x;
+    });
+}
+
+static BenchResult BenchTreeStep() {
+    const int n = 4096;
+    std::vector<Tree> trees(n), start;
+    for (auto& t : trees) { t.position = { Rand01() * SCREEN_WIDTH * 4, 400 }; t.scale = 0.8f; t.active = true; t.prevPosition = t.position; }
+    start = trees;
+    ArchetypeSize size = SizeArchetype(ARCH_TREE, 200, 300, 90, 140);
+    PlayerTick player = { nullptr, { 250, 500, 90, 140 }, { 0, 0 }, { 295, 570 }, false, 400.0f, 5.0f };
+    // One op: the scroll-only kernel plus the compaction of what left the screen
+    return Measure("tree_step", n, [&]() {
+        StepArchetype<ARCH_TREE>(trees, size, nullptr, player, 7.0f, nullptr, 0);
+        if ((int)trees.size() < n / 2) trees = start;
+        sink = (float)trees.size();
+    });
+}
+
+static BenchResult BenchSnow() {
+    const int n = 4096;
+    std::vector<SnowFlake> flakes(n);
+    for (auto& s : flakes) {
+        s.x = Rand01() * SCREEN_WIDTH; s.y = Rand01() * SCREEN_HEIGHT; s.prevX = s.x; s.prevY = s.y;
+        s.speedY = 70 + Rand01() * 100; s.driftX = Rand01() * 3.6f - 1.8f; s.size = 3; s.opacity = 1;
+    }
+    return Measure("snow_update", n, [&]() {
+        UpdateSnowflakes(flakes, n, 1.0f / 60.0f);
+        sink = flakes[n / 2].y;
+    });
+}
+
+static BenchResult BenchRain() {
+    const int n = MAX_RAIN_DROPS;
+    std::vector<RainDrop> drops(n);
+    for (auto& d : drops) {
+        d.x = Rand01() * SCREEN_WIDTH; d.y = Rand01() * SCREEN_HEIGHT; d.prevX = d.x; d.prevY = d.y;
+        d.speed = 600 + Rand01() * 500; d.length = 30; d.thickness = 2; d.opacity = 0.9f;
+    }
+    return Measure("rain_update", n, [&]() {
+        UpdateRainDrops(drops, n, 1.0f / 60.0f);
+        sink = drops[n / 2].y;
+    });
+}
+
+static BenchResult BenchBurst() {
+    std::vector<Particle> particles;
+    particles.reserve(MAX_BURST_PARTICLES);
+    // One op: a full pool of pickups bursting, then ticked until every particle has died
+    return Measure("burst_lifecycle", MAX_BURST_PARTICLES, [&]() {
+        while (PoolHasRoom(particles)) SpawnCoinBurst(particles, { Rand01() * SCREEN_WIDTH, 500 });
+        while (!particles.empty()) UpdateBurstParticles(particles, 1.0f / 60.0f);
+        sink = (float)particles.size();
+    });
+}
+
+static BenchResult BenchSkyLerp() {
+    const int n = 1024;
+    Color a = { 255, 165, 0, 45 }, b = { 0, 0, 139, 85 };
+    return Measure("sky_lerp", n, [&]() {
+        unsigned int acc = 0;
+        for (int i = 0; i < n; i++) acc += LerpColor(a, b, (float)i / n).r;
+        sink = (float)acc;
+    });
+}
+
+// ------------ Reporting --------------
+static bool WriteJson(const char* path, const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"version\": 1,\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"items\": %d, \"ns_per_op\": %.1f, \"min_ns_per_op\": %.1f, \"ns_per_item\": %.3f}%s\n",
+            r.name, r.items, r.nsPerOp, r.minNsPerOp, r.nsPerOp / r.items, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+// Reads min_ns_per_op for name out of a file written by WriteJson; < 0 when absent
+static double BaselineMinNsPerOp(const std::string& json, const char* name) {
+    std::string key = std::string("\"name\": \"") + name + "\"";
+    size_t at = json.find(key);
+    if (at == std::string::npos) return -1.0;
+    at = json.find("\"min_ns_per_op\":", at);
+    if (at == std::string::npos) return -1.0;
+    return atof(json.c_str() + at + strlen("\"min_ns_per_op\":"));
+}
+
+static bool ReadFile(const char* path, std::string& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* outPath = nullptr;
+    const char* baselinePath = nullptr;
+    const char* filter = nullptr;
+    double tolerance = 10.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+    }
+    SetTraceLogLevel(LOG_WARNING);
+    QualityInit(QUALITY_HIGH);
+    srand(1);
+
+    typedef BenchResult (*BenchFn)();
+    struct { const char* name; BenchFn fn; } benches[] = {
+        { "aabb_rects", BenchAabb }, { "placement_scan", BenchPlacement }, { "magnet_pull", BenchMagnet },
+        { "rush_pull", BenchRushPull }, { "coin_step", BenchCoinStep }, { "tree_step", BenchTreeStep },
+        { "snow_update", BenchSnow }, { "rain_update", BenchRain }, { "burst_lifecycle", BenchBurst },
+        { "sky_lerp", BenchSkyLerp },
+    };
+    std::vector<BenchResult> results;
+    for (const auto& b : benches)
+        if (!filter || strstr(b.name, filter)) results.push_back(b.fn());
+
+    std::string baseline;
+    bool haveBaseline = baselinePath && ReadFile(baselinePath, baseline);
+    if (baselinePath && !haveBaseline) printf("no baseline at %s (make bench-baseline writes one)\n", baselinePath);
+    bool regressed = false;
+    printf("%-16s %7s %12s %12s %10s", "kernel", "items", "ns/op", "min ns/op", "ns/item");
+    printf(haveBaseline ? " %12s %8s\n" : "\n", "base min", "change");
+    for (const BenchResult& r : results) {
+        printf("%-16s %7d %12.1f %12.1f %10.3f", r.name, r.items, r.nsPerOp, r.minNsPerOp, r.nsPerOp / r.items);
+        double base = haveBaseline ? BaselineMinNsPerOp(baseline, r.name) : -1.0;
+        if (base > 0.0) {
+            double change = 100.0 * (r.minNsPerOp / base - 1.0);
+            bool worse = change > tolerance;
+            regressed |= worse;
+            printf(" %12.1f %+7.1f%%%s", base, change, worse ? "  REGRESSED" : "");
+        } else if (haveBaseline) {
+            printf(" %12s", "new");
+        }
+        printf("\n");
+    }
+    if (outPath && !WriteJson(outPath, results)) {
+        printf("cannot write %s\n", outPath);
+        return 1;
+    }
+    return regressed ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include "entities.h"
+#include "sweep.h"
+#include "telemetry.h"
+
+// ------------ Entity Archetypes -----------------
+// Every scrolling entity type is one row of ARCHETYPES: how its sprite is sized,
+// how it moves, how a touch with the player is tested and what the touch does.
+// StepArchetype<ID>() is instantiated per row, so the branches on the columns
+// fold away and each type gets its own straight loop. A new obstacle type is a
+// new row (and a pool to hold it).
+enum ArchetypeId { ARCH_COIN, ARCH_MAGNET, ARCH_ROCK, ARCH_TREE, ARCH_BIRD, ARCH_IC, ARCH_COUNT };
+
+enum ArchSizing { SIZE_SCALE, SIZE_PLAYER_WIDTH, SIZE_PLAYER_HEIGHT }; // factor is the scale, or a share of the player's size
+enum ArchScroll { SCROLL_GROUND, SCROLL_OWN_SPEED };                    // own speed: Bird::speed
+enum ArchHitbox { HITBOX_NONE, HITBOX_AABB, HITBOX_MASK };
+enum ArchResponse { HIT_NONE, HIT_COIN, HIT_MAGNET, HIT_DAMAGE, HIT_SLOW };
+// What happens past the left edge: removed from the pool, left for the caller
+// to respawn, or (a single entity) switched off. Inactive entities of a
+// deactivating type stay where they are.
+enum ArchExit { EXIT_REMOVE, EXIT_RECYCLE, EXIT_DEACTIVATE };
+
+struct Archetype {
+    const char* name;
+    ArchSizing sizing;
+    float factor;
+    ArchScroll scroll;
+    bool magnetic;         // pulled towards the player while the magnet is on
+    ArchHitbox hitbox;
+    ArchResponse response;
+    int damage, coinPenalty;
+    DeathCause death;      // when its damage ends the run
+    ArchExit exit;
+    bool exitByTexture;    // leaves one full (unscaled) texture width past the edge, not its drawn width
+};
+
+constexpr Archetype ARCHETYPES[ARCH_COUNT] = {
+    // name     sizing              factor scroll          magnet hitbox       response    dmg coins death       exit             byTexture
+    { "coin",   SIZE_PLAYER_WIDTH,  0.5f,  SCROLL_GROUND,    true,  HITBOX_AABB, HIT_COIN,     0, 0, DEATH_NONE, EXIT_RECYCLE,    true  },
+    { "magnet", SIZE_PLAYER_WIDTH,  0.6f,  SCROLL_GROUND,    false, HITBOX_AABB, HIT_MAGNET,   0, 0, DEATH_NONE, EXIT_REMOVE,     true  },
+    { "rock",   SIZE_PLAYER_WIDTH,  1.5f,  SCROLL_GROUND,    false, HITBOX_MASK, HIT_DAMAGE,  40, 0, DEATH_ROCK, EXIT_REMOVE,     false },
+    { "tree",   SIZE_SCALE,         0.8f,  SCROLL_GROUND,    false, HITBOX_NONE, HIT_NONE,     0, 0, DEATH_NONE, EXIT_REMOVE,     false },
+    { "bird",   SIZE_SCALE,         0.25f, SCROLL_OWN_SPEED, false, HITBOX_MASK, HIT_DAMAGE,  30, 3, DEATH_BIRD, EXIT_REMOVE,     false },
+    { "ic",     SIZE_PLAYER_HEIGHT, 1.0f,  SCROLL_GROUND,    false, HITBOX_MASK, HIT_SLOW,     0, 0, DEATH_NONE, EXIT_DEACTIVATE, false },
+};
+
+// Sizes that follow from the texture and the player, worked out once per run
+struct ArchetypeSize {
+    float scale;
+    Vector2 size;      // drawn size
+    float exitX;       // gone once position.x is below this
+};
+
+inline ArchetypeSize SizeArchetype(ArchetypeId id, int texWidth, int texHeight, float playerWidth, float playerHeight) {
+    const Archetype& a = ARCHETYPES[id];
+    float scale = a.sizing == SIZE_PLAYER_WIDTH ? playerWidth * a.factor / texWidth
+                : a.sizing == SIZE_PLAYER_HEIGHT ? playerHeight * a.factor / texHeight : a.factor;
+    ArchetypeSize s;
+    s.scale = scale;
+    s.size = { texWidth * scale, texHeight * scale };
+    s.exitX = -(a.exitByTexture ? (float)texWidth : s.size.x);
+    return s;
+}
+
+// The player over one tick, shared by every kernel of the tick
+struct PlayerTick {
+    const HitMask* mask;
+    Rectangle start;           // where it was at the start of the tick
+    Vector2 delta;
+    Vector2 center;            // magnet target
+    bool magnetOn;
+    float magnetRadius, magnetStep;
+};
+
+#define MAX_TICK_HITS 256   // per kernel call; past it, touched entities are left active
+
+struct ArchetypeHit {
+    int index;                 // before the pool was compacted
+    Vector2 at;                // entity center at the moment of impact
+};
+
+inline float EntitySpeed(const Bird& b, float) { return b.speed; }
+template <typename T> inline float EntitySpeed(const T&, float groundSpeed) { return groundSpeed; }
+
+// One tick of count entities: magnet pull, scroll, the swept test against the
+// player and the exit past the left edge. Touched entities are switched off and
+// listed in hits (up to maxHits) for the caller to apply. Removed entities are
+// compacted out in order and count shrinks. Returns the hit count.
+template <ArchetypeId ID, typename T>
+int StepArchetype(T* items, int& count, const ArchetypeSize& sz, const HitMask* mask, const PlayerTick& player,
+                  float groundSpeed, ArchetypeHit* hits, int maxHits) {
+    constexpr Archetype A = ARCHETYPES[ID];
+    const Vector2 half = { sz.size.x / 2.0f, sz.size.y / 2.0f };
+    int hitCount = 0, kept = 0;
+    for (int i = 0; i < count; i++) {
+        T& e = items[i];
+        if (A.exit == EXIT_DEACTIVATE && !e.active) continue;
+        if (A.magnetic && player.magnetOn && e.active)
+            MagnetPull(e.position, half, player.center, player.magnetRadius, player.magnetStep);
+        e.position.x -= A.scroll == SCROLL_OWN_SPEED ? EntitySpeed(e, groundSpeed) : groundSpeed;
+        if (A.hitbox != HITBOX_NONE && e.active && hitCount < maxHits) {
+            // From where it started the tick to where it is now, pull and scroll included
+            Rectangle start = { e.prevPosition.x, e.prevPosition.y, sz.size.x, sz.size.y };
+            Vector2 delta = { e.position.x - e.prevPosition.x, e.position.y - e.prevPosition.y };
+            bool hit;
+            float toi;
+            if (A.hitbox == HITBOX_MASK) {
+                hit = SweptMaskHit(*mask, start, delta, *player.mask, player.start, player.delta, &toi);
+            } else {
+                SweepResult r = SweptAabb(player.start, player.delta, start, delta);
+                hit = r.hit;
+                toi = r.enter;
+            }
+            if (hit) {
+                e.active = false;
+                hits[hitCount++] = { i, { start.x + delta.x * toi + half.x, start.y + delta.y * toi + half.y } };
+            }
+        }
+        if (e.position.x < sz.exitX) {
+            if (A.exit == EXIT_REMOVE) continue;
+            if (A.exit == EXIT_DEACTIVATE) e.active = false;
+        }
+        if (A.exit == EXIT_REMOVE && kept != i) items[kept] = e;
+        kept++;
+    }
+    if (A.exit == EXIT_REMOVE) count = kept;
+    return hitCount;
+}
+
+// Pool form: shrinking keeps the capacity, nothing is freed or allocated
+template <ArchetypeId ID, typename T>
+int StepArchetype(std::vector<T>& pool, const ArchetypeSize& sz, const HitMask* mask, const PlayerTick& player,
+                  float groundSpeed, ArchetypeHit* hits, int maxHits) {
+    int count = (int)pool.size();
+    int n = StepArchetype<ID>(pool.data(), count, sz, mask, player, groundSpeed, hits, maxHits);
+    pool.resize(count);
+    return n;
+}
@@ -0,0 +1,46 @@
+#include "arena.h"
+#include "raylib.h"
+#include <cstdlib>
+#include <cstring>
+
+static unsigned char* base = nullptr;
+static size_t capacity = 0, used = 0, highWater = 0;
+static bool warnedFull = false;
+
+void FrameArenaInit(size_t size) {
+    FrameArenaShutdown();
+    base = (unsigned char*)malloc(size);
+    capacity = base ? size : 0;
+    used = highWater = 0;
+}
+
+void FrameArenaShutdown() {
+    free(base);
+    base = nullptr;
+    capacity = used = 0;
+}
+
+void FrameArenaReset() {
+    if (used > highWater) highWater = used;
+    used = 0;
+}
+
+void* FrameAlloc(size_t size, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (start + size > capacity) {
+        if (!warnedFull) TraceLog(LOG_WARNING, "ARENA: frame arena full (%d bytes), allocation dropped", (int)capacity);
+        warnedFull = true;
+        return nullptr;
+    }
+    used = start + size;
+    return base + start;
+}
+
+char* FrameStrDup(const char* text) {
+    size_t len = strlen(text) + 1;
+    char* copy = (char*)FrameAlloc(len, 1);
+    if (copy) memcpy(copy, text, len);
+    return copy;
+}
+
+size_t FrameArenaHighWater() { return used > highWater ? used : highWater; }
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+
+// ------------ Frame Arena --------------
+// Bump allocator for data that lives until the end of the frame (e.g. recorded
+// text). One block is allocated up front; FrameArenaReset() rewinds it.
+void FrameArenaInit(size_t capacity);
+void FrameArenaShutdown();
+void FrameArenaReset();                      // start of every frame
+void* FrameAlloc(size_t size, size_t align = alignof(std::max_align_t)); // nullptr when full
+char* FrameStrDup(const char* text);
+size_t FrameArenaHighWater();                // most bytes used by any frame
@@ -0,0 +1,237 @@
+#include "assets.h"
+#include <algorithm>
+#include <cstring>
+
+static AssetInfo assets[MAX_ASSETS];
+static int assetCount = 0;
+static AssetPoolStats pools[ASSET_POOL_COUNT] = {
+    { 0, 0, 0, 128LL << 20, 0 },   // GPU: resident textures plus the render targets
+    { 0, 0, 0, 16LL << 20, 0 },    // audio: decoded sounds and stream buffers
+};
+static bool overBudget[ASSET_POOL_COUNT];
+static long long frame = 0;
+#define MAX_FAILED_NAMES 8
+static int failedLoads = 0;
+static char failedNames[MAX_FAILED_NAMES][48];
+static int lastTouched = -1;     // draws come in runs of one texture
+
+static AssetPool PoolOf(AssetKind kind) {
+    return (kind == ASSET_SOUND || kind == ASSET_MUSIC) ? ASSET_POOL_AUDIO : ASSET_POOL_GPU;
+}
+
+static void CheckBudget(AssetPool pool) {
+    AssetPoolStats& p = pools[pool];
+    bool over = p.budget > 0 && p.bytes > p.budget;
+    if (over && !overBudget[pool])
+        TraceLog(LOG_WARNING, "ASSETS: %s memory %.1f MB is over its %.1f MB budget", AssetPoolName(pool),
+            p.bytes / 1048576.0, p.budget / 1048576.0);
+    overBudget[pool] = over;
+}
+
+static void Register(AssetKind kind, unsigned long long handle, long long bytes, const char* name, const char* owner) {
+    if (assetCount == MAX_ASSETS) {
+        TraceLog(LOG_WARNING, "ASSETS: registry full, %s is not tracked", name);
+        return;
+    }
+    AssetInfo& a = assets[assetCount++];
+    memset(&a, 0, sizeof(a));
+    a.kind = kind;
+    a.handle = handle;
+    a.bytes = bytes;
+    a.owner = owner;
+    strncpy(a.name, name, sizeof(a.name) - 1);
+    a.loadFrame = frame;
+    a.lastUse = -1;
+    AssetPoolStats& p = pools[PoolOf(kind)];
+    p.count++;
+    p.bytes += bytes;
+    if (p.bytes > p.peakBytes) p.peakBytes = p.bytes;
+    CheckBudget(PoolOf(kind));
+}
+
+static int Find(AssetKind kind, unsigned long long handle) {
+    for (int i = 0; i < assetCount; i++)
+        if (assets[i].handle == handle && (assets[i].kind == kind ||
+            (kind == ASSET_TEXTURE && assets[i].kind == ASSET_RENDER_TEXTURE))) return i;
+    return -1;
+}
+
+static void Unregister(AssetKind kind, unsigned long long handle) {
+    int i = Find(kind, handle);
+    if (i < 0) return;
+    AssetPoolStats& p = pools[PoolOf(assets[i].kind)];
+    p.count--;
+    p.bytes -= assets[i].bytes;
+    assets[i] = assets[--assetCount];
+    lastTouched = -1;
+    CheckBudget(PoolOf(kind));
+}
+
+static long long TextureBytes(Texture2D t) {
+    long long bytes = GetPixelDataSize(t.width, t.height, t.format);
+    // A full mip chain adds a third
+    return t.mipmaps > 1 ? bytes * 4 / 3 : bytes;
+}
+
+static long long AudioBytes(AudioStream s, unsigned int frames) {
+    return (long long)frames * s.channels * (s.sampleSize / 8);
+}
+
+static void LoadFailed(const char* path) {
+    if (failedLoads < MAX_FAILED_NAMES) strncpy(failedNames[failedLoads], path, sizeof(failedNames[0]) - 1);
+    failedLoads++;
+}
+
+static unsigned long long AudioHandle(AudioStream s) { return (unsigned long long)(size_t)s.buffer; }
+
+Texture2D AssetLoadTexture(const char* path, const char* owner) {
+    Texture2D t = LoadTexture(path);
+    if (t.id == 0) LoadFailed(path);
+    else Register(ASSET_TEXTURE, t.id, TextureBytes(t), path, owner);
+    return t;
+}
+
+Sound AssetLoadSound(const char* path, const char* owner) {
+    Sound s = LoadSound(path);
+    if (s.stream.buffer == nullptr) LoadFailed(path);
+    else Register(ASSET_SOUND, AudioHandle(s.stream), AudioBytes(s.stream, s.frameCount), path, owner);
+    return s;
+}
+
+Music AssetLoadMusic(const char* path, const char* owner, int bufferFrames) {
+    Music m = LoadMusicStream(path);
+    // Streamed: only the two halves of the stream buffer are decoded at a time
+    if (m.stream.buffer == nullptr) LoadFailed(path);
+    else Register(ASSET_MUSIC, AudioHandle(m.stream), AudioBytes(m.stream, 2 * bufferFrames), path, owner);
+    return m;
+}
+
+void AssetUnloadTexture(Texture2D texture) {
+    if (texture.id == 0) return;
+    Unregister(ASSET_TEXTURE, texture.id);
+    UnloadTexture(texture);
+}
+
+void AssetUnloadSound(Sound sound) {
+    if (sound.stream.buffer == nullptr) return;
+    Unregister(ASSET_SOUND, AudioHandle(sound.stream));
+    UnloadSound(sound);
+}
+
+void AssetUnloadMusic(Music music) {
+    if (music.stream.buffer == nullptr) return;
+    Unregister(ASSET_MUSIC, AudioHandle(music.stream));
+    UnloadMusicStream(music);
+}
+
+void AssetTrackRenderTexture(RenderTexture2D target, const char* name, const char* owner) {
+    if (target.id == 0) return;
+    // Color attachment plus the depth renderbuffer raylib attaches
+    long long bytes = TextureBytes(target.texture) + (long long)target.depth.width * target.depth.height * 4;
+    Register(ASSET_RENDER_TEXTURE, target.texture.id, bytes, name, owner);
+}
+
+void AssetTrackTexture(Texture2D texture, const char* name, const char* owner) {
+    if (texture.id != 0) Register(ASSET_TEXTURE, texture.id, TextureBytes(texture), name, owner);
+}
+
+void AssetUntrack(Texture2D texture) {
+    if (texture.id != 0) Unregister(ASSET_TEXTURE, texture.id);
+}
+
+void AssetTouchTexture(unsigned int id, float drawnW, float drawnH) {
+    if (lastTouched < 0 || assets[lastTouched].handle != id ||
+        (assets[lastTouched].kind != ASSET_TEXTURE && assets[lastTouched].kind != ASSET_RENDER_TEXTURE)) {
+        lastTouched = Find(ASSET_TEXTURE, id);
+        if (lastTouched < 0) return;
+    }
+    AssetInfo& a = assets[lastTouched];
+    a.lastUse = frame;
+    int w = (int)(drawnW < 0 ? -drawnW : drawnW), h = (int)(drawnH < 0 ? -drawnH : drawnH);
+    if (w > a.drawnW) a.drawnW = w;
+    if (h > a.drawnH) a.drawnH = h;
+}
+
+void AssetTouchSound(Sound sound) {
+    int i = Find(ASSET_SOUND, AudioHandle(sound.stream));
+    if (i >= 0) assets[i].lastUse = frame;
+}
+
+void AssetTouchMusic(Music music) {
+    int i = Find(ASSET_MUSIC, AudioHandle(music.stream));
+    if (i >= 0) assets[i].lastUse = frame;
+}
+
+void AssetSetBudget(AssetPool pool, long long bytes) {
+    pools[pool].budget = bytes;
+    CheckBudget(pool);
+}
+
+void AssetsEndFrame() {
+    for (int p = 0; p < ASSET_POOL_COUNT; p++)
+        if (overBudget[p]) pools[p].overBudgetFrames++;
+    frame++;
+}
+
+AssetPoolStats AssetGetPoolStats(AssetPool pool) { return pools[pool]; }
+long long AssetsFrame() { return frame; }
+
+int AssetsLargest(const AssetInfo** out, int max) {
+    static const AssetInfo* order[MAX_ASSETS];
+    for (int i = 0; i < assetCount; i++) order[i] = &assets[i];
+    int n = std::min(max, assetCount);
+    std::partial_sort(order, order + n, order + assetCount,
+        [](const AssetInfo* a, const AssetInfo* b) { return a->bytes > b->bytes; });
+    for (int i = 0; i < n; i++) out[i] = order[i];
+    return n;
+}
+
+const char* AssetKindName(AssetKind kind) {
+    static const char* names[ASSET_KIND_COUNT] = { "texture", "target", "sound", "music" };
+    return names[kind];
+}
+
+const char* AssetPoolName(AssetPool pool) {
+    static const char* names[ASSET_POOL_COUNT] = { "gpu", "audio" };
+    return names[pool];
+}
+
+static void PrintAsset(FILE* f, const AssetInfo& a) {
+    char used[24];
+    if (a.lastUse < 0) snprintf(used, sizeof(used), "never");
+    else snprintf(used, sizeof(used), "%lld ago", frame - a.lastUse);
+    fprintf(f, "  %-8s %9.1f KB  %-10s %-12s", AssetKindName(a.kind), a.bytes / 1024.0, a.owner, used);
+    if (a.drawnW > 0) fprintf(f, " drawn <= %dx%d ", a.drawnW, a.drawnH);
+    fprintf(f, " %s\n", a.name);
+}
+
+void AssetsDump(FILE* f) {
+    const AssetInfo* order[MAX_ASSETS];
+    int n = AssetsLargest(order, MAX_ASSETS);
+    fprintf(f, "assets at frame %lld:\n", frame);
+    for (int i = 0; i < n; i++) PrintAsset(f, *order[i]);
+    for (int p = 0; p < ASSET_POOL_COUNT; p++)
+        fprintf(f, "  %s: %d assets, %.1f MB of %.1f MB budget\n", AssetPoolName((AssetPool)p), pools[p].count,
+            pools[p].bytes / 1048576.0, pools[p].budget / 1048576.0);
+}
+
+bool PrintAssetReport() {
+    bool ok = true;
+    for (int p = 0; p < ASSET_POOL_COUNT; p++) {
+        const AssetPoolStats& s = pools[p];
+        printf("assets %-5s peak %.1f MB, budget %.1f MB, %lld frames over\n", AssetPoolName((AssetPool)p),
+            s.peakBytes / 1048576.0, s.budget / 1048576.0, s.overBudgetFrames);
+        if (s.overBudgetFrames > 0 || (s.budget > 0 && s.peakBytes > s.budget)) ok = false;
+    }
+    if (failedLoads > 0) {
+        printf("assets: %d files failed to load:", failedLoads);
+        for (int i = 0; i < failedLoads && i < MAX_FAILED_NAMES; i++) printf(" %s", failedNames[i]);
+        printf("\n");
+    }
+    if (assetCount > 0) {
+        printf("assets: %d still loaded at shutdown (leaked):\n", assetCount);
+        for (int i = 0; i < assetCount; i++) PrintAsset(stdout, assets[i]);
+        ok = false;
+    }
+    return ok;
+}
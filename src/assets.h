@@ -0,0 +1,61 @@
+#pragma once
+#include "raylib.h"
+#include <cstdio>
+
+// ------------ Asset Registry --------------
+// Every texture, render target, sound and music stream is loaded (or, when
+// another module creates it, tracked) through here with its size in bytes, the
+// system that owns it and the frame it was last drawn or played. The sizes are
+// summed per memory pool and checked against budgets; anything still registered
+// at shutdown is a leak.
+enum AssetKind { ASSET_TEXTURE, ASSET_RENDER_TEXTURE, ASSET_SOUND, ASSET_MUSIC, ASSET_KIND_COUNT };
+enum AssetPool { ASSET_POOL_GPU, ASSET_POOL_AUDIO, ASSET_POOL_COUNT }; // video memory, decoded audio in RAM
+
+#define MAX_ASSETS 256
+
+struct AssetInfo {
+    AssetKind kind;
+    unsigned long long handle;   // texture id, or the audio buffer address
+    long long bytes;
+    const char* owner;
+    char name[48];
+    long long loadFrame, lastUse; // lastUse < 0: never used
+    int drawnW, drawnH;           // largest size a texture was drawn at
+};
+
+struct AssetPoolStats {
+    int count;
+    long long bytes, peakBytes, budget;
+    long long overBudgetFrames;
+};
+
+Texture2D AssetLoadTexture(const char* path, const char* owner);
+Sound AssetLoadSound(const char* path, const char* owner);
+// bufferFrames: the stream buffer size given to SetAudioStreamBufferSizeDefault()
+Music AssetLoadMusic(const char* path, const char* owner, int bufferFrames);
+void AssetUnloadTexture(Texture2D texture);
+void AssetUnloadSound(Sound sound);
+void AssetUnloadMusic(Music music);
+
+// Render targets and generated textures made elsewhere
+void AssetTrackRenderTexture(RenderTexture2D target, const char* name, const char* owner);
+void AssetTrackTexture(Texture2D texture, const char* name, const char* owner);
+void AssetUntrack(Texture2D texture);
+
+void AssetTouchTexture(unsigned int id, float drawnW, float drawnH); // called by RenderFlush()
+void AssetTouchSound(Sound sound);
+void AssetTouchMusic(Music music);
+
+void AssetSetBudget(AssetPool pool, long long bytes);
+void AssetsEndFrame();   // advances the frame counter and checks the budgets
+
+AssetPoolStats AssetGetPoolStats(AssetPool pool);
+long long AssetsFrame();
+// Up to max live assets, largest first
+int AssetsLargest(const AssetInfo** out, int max);
+const char* AssetKindName(AssetKind kind);
+const char* AssetPoolName(AssetPool pool);
+
+void AssetsDump(FILE* f);  // every live asset, largest first
+// Peaks, budgets, failed loads and leaks; false on a leak or a budget overrun
+bool PrintAssetReport();
@@ -0,0 +1,74 @@
+#include "coinrush.h"
+#include "render.h"
+#include "simrng.h"
+#include "entities.h"
+#include <cmath>
+#include <cstring>
+
+// Coin centers. The arrays are padded past count to a multiple of 4, so the
+// kernel always works on whole vectors; the padding lanes are ignored.
+alignas(16) static float rushX[RUSH_MAX_COINS], rushY[RUSH_MAX_COINS];
+alignas(16) static float rushPrevX[RUSH_MAX_COINS], rushPrevY[RUSH_MAX_COINS];
+static int rushCount = 0;
+static int gone[RUSH_MAX_COINS];
+static Vector2 pickedAt[RUSH_MAX_COINS];
+static Vector2 drawPos[RUSH_MAX_COINS];   // read by the render flush
+
+void CoinRushFill(int count, Rectangle area) {
+    for (int i = 0; i < count && rushCount < RUSH_MAX_COINS; i++, rushCount++) {
+        rushX[rushCount] = SimRandomFloat(area.x, area.x + area.width);
+        rushY[rushCount] = SimRandomFloat(area.y, area.y + area.height);
+        rushPrevX[rushCount] = rushX[rushCount];
+        rushPrevY[rushCount] = rushY[rushCount];
+    }
+}
+
+void CoinRushClear() { rushCount = 0; }
+int CoinRushCount() { return rushCount; }
+
+// Pickups in one cell of the grid share a burst at their centroid
+static int MergeBursts(const Vector2* at, int n, float cell, RushBurst* out) {
+    int cx[RUSH_MAX_BURSTS], cy[RUSH_MAX_BURSTS];
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        int x = (int)floorf(at[i].x / cell), y = (int)floorf(at[i].y / cell);
+        int b = 0;
+        while (b < count && (cx[b] != x || cy[b] != y)) b++;
+        if (b == count) {
+            if (count == RUSH_MAX_BURSTS) b = count - 1; // out of slots: fold into the last
+            else { cx[b] = x; cy[b] = y; out[b] = { { 0, 0 }, 0 }; count++; }
+        }
+        out[b].at.x += at[i].x;
+        out[b].at.y += at[i].y;
+        out[b].coins++;
+    }
+    for (int b = 0; b < count; b++) { out[b].at.x /= out[b].coins; out[b].at.y /= out[b].coins; }
+    return count;
+}
+
+RushTickResult CoinRushTick(Vector2 target, float pull, float scroll, float pickupRadius, float leftEdge, float burstCell) {
+    RushTickResult r;
+    memset(&r, 0, sizeof(r));
+    int goneCount = PullCoinField(rushX, rushY, rushCount, target, pull, scroll, pickupRadius, leftEdge, gone, pickedAt, &r.picked);
+    r.lost = goneCount - r.picked;
+    // Order does not matter in the field: fill each hole with the last coin, highest hole first
+    for (int g = goneCount - 1; g >= 0; g--) {
+        int i = gone[g], last = --rushCount;
+        rushX[i] = rushX[last]; rushY[i] = rushY[last];
+        rushPrevX[i] = rushPrevX[last]; rushPrevY[i] = rushPrevY[last];
+    }
+    r.burstCount = MergeBursts(pickedAt, r.picked, burstCell, r.bursts);
+    return r;
+}
+
+void CoinRushSnapshot() {
+    memcpy(rushPrevX, rushX, rushCount * sizeof(float));
+    memcpy(rushPrevY, rushY, rushCount * sizeof(float));
+}
+
+void CoinRushDraw(Texture2D texture, float scale, float alpha) {
+    float hw = texture.width * scale / 2.0f, hh = texture.height * scale / 2.0f;
+    for (int i = 0; i < rushCount; i++)
+        drawPos[i] = { rushPrevX[i] + (rushX[i] - rushPrevX[i]) * alpha - hw, rushPrevY[i] + (rushY[i] - rushPrevY[i]) * alpha - hh };
+    CmdTextureBatch(texture, drawPos, rushCount, scale, WHITE);
+}
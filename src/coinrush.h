@@ -0,0 +1,37 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Coin Rush --------------
+// A bonus segment: thousands of coins fill the screen and are all pulled to the
+// player at once. The field is kept apart from the regular coins as plain
+// arrays of centers (structure of arrays), so PullCoinField() moves four coins
+// per SSE instruction with a reciprocal square root instead of sqrt and
+// divides. Pickups are gathered per tick and their bursts merged per cell, so a
+// stream of pickups costs a handful of bursts, not one each.
+#define RUSH_MAX_COINS 8192
+#define RUSH_MAX_BURSTS 8
+
+struct RushBurst {
+    Vector2 at;        // centroid of the pickups merged into it
+    int coins;
+};
+
+struct RushTickResult {
+    int picked, lost;  // lost: scrolled off the left edge
+    int burstCount;
+    RushBurst bursts[RUSH_MAX_BURSTS];
+};
+
+// Scatters count more coin centers over area (up to RUSH_MAX_COINS in total)
+void CoinRushFill(int count, Rectangle area);
+void CoinRushClear();
+int CoinRushCount();
+
+// One tick: every coin scrolls left by scroll and steps pull pixels towards
+// target; the ones within pickupRadius of it are collected, the ones left of
+// leftEdge dropped. Bursts are merged per burstCell pixels.
+RushTickResult CoinRushTick(Vector2 target, float pull, float scroll, float pickupRadius, float leftEdge, float burstCell);
+void CoinRushSnapshot();   // start-of-tick positions, for interpolated drawing
+
+// Records the coins at alpha between the last two ticks as one batch command
+void CoinRushDraw(Texture2D texture, float scale, float alpha);
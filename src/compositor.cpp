@@ -0,0 +1,74 @@
+#include "compositor.h"
+#include "render.h"
+#include <cmath>
+
+#define MAX_LAYERS 16
+
+struct Layer {
+    bool overlay;
+    Texture2D texture;
+    Rectangle source, dest;
+    Color color;
+};
+
+static Layer layers[MAX_LAYERS];
+static int layerCount = 0;
+static int screenW = 0, screenH = 0;
+static CompositorStats stats;
+
+void CompositorBegin(int screenWidth, int screenHeight) {
+    layerCount = 0;
+    screenW = screenWidth;
+    screenH = screenHeight;
+    stats = CompositorStats{};
+}
+
+static float WrapX(float x, int width) {
+    if (width <= 0) return x;
+    float w = fmodf(x, (float)width);
+    return w < 0 ? w + width : w;
+}
+
+// Same texture, tint and placement, and a source offset that only differs by
+// whole texture widths: with repeat wrapping it samples the very same texels
+static bool SameLayer(const Layer& a, const Layer& b) {
+    if (a.overlay || b.overlay) return false;
+    if (a.texture.id != b.texture.id) return false;
+    if (*(const unsigned int*)&a.color != *(const unsigned int*)&b.color) return false;
+    if (a.dest.x != b.dest.x || a.dest.y != b.dest.y || a.dest.width != b.dest.width || a.dest.height != b.dest.height) return false;
+    if (a.source.y != b.source.y || a.source.width != b.source.width || a.source.height != b.source.height) return false;
+    return fabsf(WrapX(a.source.x, a.texture.width) - WrapX(b.source.x, b.texture.width)) < 0.01f;
+}
+
+void CompositorLayer(Texture2D texture, Rectangle source, Rectangle dest, Color tint) {
+    stats.layersDeclared++;
+    Layer l = { false, texture, source, dest, tint };
+    for (int i = 0; i < layerCount; i++) {
+        // A repeat is only redundant while no overlay sits between the two
+        if (layers[i].overlay) continue;
+        bool overlayAfter = false;
+        for (int j = i + 1; j < layerCount; j++) if (layers[j].overlay) overlayAfter = true;
+        if (!overlayAfter && SameLayer(layers[i], l)) return;
+    }
+    if (layerCount < MAX_LAYERS) layers[layerCount++] = l;
+}
+
+void CompositorOverlay(Color color) {
+    stats.layersDeclared++;
+    if (color.a == 0) return;
+    if (layerCount < MAX_LAYERS) {
+        Layer l = { true, Texture2D{}, Rectangle{}, Rectangle{ 0, 0, (float)screenW, (float)screenH }, color };
+        layers[layerCount++] = l;
+    }
+}
+
+CompositorStats CompositorFlush() {
+    for (int i = 0; i < layerCount; i++) {
+        const Layer& l = layers[i];
+        if (l.overlay) CmdRectangleRec(l.dest, l.color);
+        else CmdTexturePro(l.texture, l.source, l.dest, { 0, 0 }, 0.0f, l.color);
+        stats.layersDrawn++;
+    }
+    layerCount = 0;
+    return stats;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Layer Compositor --------------
+// The full-screen layers of a frame are declared here instead of drawn directly.
+// On flush, layers that repeat one already in the stack are dropped, as are
+// fully transparent overlays.
+struct CompositorStats {
+    int layersDeclared, layersDrawn;  // textured layers and overlays alike
+};
+
+void CompositorBegin(int screenWidth, int screenHeight);
+// Textured layer; source.x may run past the texture width (the texture wraps)
+void CompositorLayer(Texture2D texture, Rectangle source, Rectangle dest, Color tint);
+// Flat color over everything declared so far
+void CompositorOverlay(Color color);
+// Emits the surviving layers into the command buffer
+CompositorStats CompositorFlush();
@@ -0,0 +1,5 @@
+#pragma once
+
+// CPU time used by this process so far, in seconds (all threads).
+// Kept out of raylib.h's way: the Windows version needs windows.h.
+double ProcessCpuSeconds();
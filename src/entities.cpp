@@ -0,0 +1,143 @@
+#include "entities.h"
+#include "quality.h"
+#include "memtrack.h"
+#include "simrng.h"
+#include <cmath>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ENTITIES_SSE 1
+#endif
+
+#define PULL_DEAD_ZONE 5.0f   // no pull closer than this: the step would overshoot
+
+Color LerpColor(Color color1, Color color2, float t) {
+    Color result;
+    result.r = (unsigned char)(color1.r + (color2.r - color1.r) * t);
+    result.g = (unsigned char)(color1.g + (color2.g - color1.g) * t);
+    result.b = (unsigned char)(color1.b + (color2.b - color1.b) * t);
+    result.a = (unsigned char)(color1.a + (color2.a - color1.a) * t);
+    return result;
+}
+float Distance(Vector2 a, Vector2 b) { return sqrtf((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)); }
+Vector2 Normalize(Vector2 v) {
+    float length = sqrtf(v.x * v.x + v.y * v.y);
+    if (length > 0) return { v.x / length, v.y / length };
+    return { 0, 0 };
+}
+
+void MagnetPull(Vector2& pos, Vector2 half, Vector2 target, float radius, float step) {
+    float dx = target.x - (pos.x + half.x), dy = target.y - (pos.y + half.y);
+    float d2 = dx * dx + dy * dy;
+    // Squared distances for the range test, one sqrt for the direction
+    if (d2 < radius * radius && d2 > PULL_DEAD_ZONE * PULL_DEAD_ZONE) {
+        float k = step / sqrtf(d2);
+        pos.x += dx * k;
+        pos.y += dy * k;
+    }
+}
+
+int PullCoinField(float* x, float* y, int count, Vector2 target, float pull, float scroll,
+                  float pickupRadius, float leftEdge, int* gone, Vector2* pickedAt, int* picked) {
+    int goneCount = 0, pickedCount = 0;
+    const float pickup2 = pickupRadius * pickupRadius, dead2 = PULL_DEAD_ZONE * PULL_DEAD_ZONE;
+#ifdef ENTITIES_SSE
+    const __m128 tx = _mm_set1_ps(target.x), ty = _mm_set1_ps(target.y);
+    const __m128 pull4 = _mm_set1_ps(pull), scroll4 = _mm_set1_ps(scroll);
+    const __m128 pickup4 = _mm_set1_ps(pickup2), dead4 = _mm_set1_ps(dead2), left4 = _mm_set1_ps(leftEdge);
+    for (int i = 0; i < count; i += 4) {
+        const __m128 px0 = _mm_load_ps(x + i), py0 = _mm_load_ps(y + i);
+        __m128 dx = _mm_sub_ps(tx, px0), dy = _mm_sub_ps(ty, py0);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        // Direction times step from the approximate 1/sqrt (12 bits is plenty for a step)
+        __m128 k = _mm_mul_ps(_mm_rsqrt_ps(_mm_max_ps(d2, dead4)), pull4);
+        k = _mm_and_ps(k, _mm_cmpgt_ps(d2, dead4));
+        __m128 px = _mm_sub_ps(_mm_add_ps(px0, _mm_mul_ps(dx, k)), scroll4);
+        __m128 py = _mm_add_ps(py0, _mm_mul_ps(dy, k));
+        _mm_store_ps(x + i, px);
+        _mm_store_ps(y + i, py);
+        // Picked up where it was at the start of the tick, else dropped once past the edge
+        int pickMask = _mm_movemask_ps(_mm_cmplt_ps(d2, pickup4));
+        int goneMask = pickMask | _mm_movemask_ps(_mm_cmplt_ps(px, left4));
+        if (goneMask == 0) continue;
+        alignas(16) float ox[4], oy[4];
+        _mm_store_ps(ox, px0);
+        _mm_store_ps(oy, py0);
+        for (int lane = 0; lane < 4 && i + lane < count; lane++) {
+            if (!(goneMask & (1 << lane))) continue;
+            gone[goneCount++] = i + lane;
+            if (pickMask & (1 << lane)) pickedAt[pickedCount++] = { ox[lane], oy[lane] };
+        }
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        Vector2 start = { x[i], y[i] };
+        float dx = target.x - start.x, dy = target.y - start.y;
+        float d2 = dx * dx + dy * dy;
+        float k = d2 > dead2 ? pull / sqrtf(d2) : 0.0f;
+        x[i] += dx * k - scroll;
+        y[i] += dy * k;
+        bool pick = d2 < pickup2;
+        if (pick) pickedAt[pickedCount++] = start;
+        if (pick || x[i] < leftEdge) gone[goneCount++] = i;
+    }
+#endif
+    *picked = pickedCount;
+    return goneCount;
+}
+
+void SpawnCoinBurst(std::vector<Particle>& burstParticles, Vector2 pos) {
+    MemScope scope(MEM_TAG_PARTICLES);
+    int numParticles = Quality().burstParticles;
+    for (int i = 0; i < numParticles && PoolHasRoom(burstParticles); i++) {
+        float angle = 2 * PI * i / numParticles;
+        float speed = 180 + SimRandomValue(-30, 30);
+        Vector2 vel = {cosf(angle) * speed, sinf(angle) * speed - SimRandomValue(30, 90)};
+        Particle p;
+        p.position = pos;
+        p.prevPosition = pos;
+        p.velocity = vel;
+        p.life = 0.23f + SimRandomValue(0, 10) / 100.0f;
+        p.maxLife = p.life;
+        p.color = GOLD;
+        burstParticles.push_back(p);
+    }
+}
+
+void UpdateBurstParticles(std::vector<Particle>& burstParticles, float dt) {
+    for (auto it = burstParticles.begin(); it != burstParticles.end(); ) {
+        it->position.x += it->velocity.x * dt;
+        it->position.y += it->velocity.y * dt;
+        it->velocity.y += 800.0f * dt;
+        it->life -= dt;
+        if (it->life <= 0.0f) it = burstParticles.erase(it); else ++it;
+    }
+}
+
+void UpdateSnowflakes(std::vector<SnowFlake>& snowflakes, int count, float dt) {
+    for (int i = 0; i < count; i++) {
+        SnowFlake& s = snowflakes[i];
+        s.y += s.speedY * dt;
+        s.x += s.driftX * dt * 12.0f; // Stronger drift
+
+        // Wrap snowflakes to the top when out of screen
+        if (s.y > SCREEN_HEIGHT) {
+            s.y = -s.size;
+            s.x = SimRandomValue(0, SCREEN_WIDTH);
+            s.prevX = s.x; s.prevY = s.y;
+        }
+        if (s.x < 0) { s.x += SCREEN_WIDTH; s.prevX += SCREEN_WIDTH; }
+        if (s.x > SCREEN_WIDTH) { s.x -= SCREEN_WIDTH; s.prevX -= SCREEN_WIDTH; }
+    }
+}
+
+void UpdateRainDrops(std::vector<RainDrop>& rainDrops, int count, float dt) {
+    for (int i = 0; i < count; i++) {
+        RainDrop& drop = rainDrops[i];
+        drop.y += drop.speed * dt;
+        if (drop.y > SCREEN_HEIGHT) {
+            drop.x = (float)SimRandomValue(0, SCREEN_WIDTH);
+            drop.y = -SimRandomValue(10, 400);
+            drop.prevX = drop.x; drop.prevY = drop.y;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// Playfield size; weather wraps around its edges
+#define SCREEN_WIDTH 1500
+#define SCREEN_HEIGHT 800
+
+// ------------ Entity Pools -----------------
+// Entity vectors are reserved to these capacities once at startup and spawns
+// are skipped when a pool is full, so play never grows (allocates) a vector.
+const int MAX_COINS = 32;
+const int MAX_MAGNETS = 8;
+const int MAX_ROCKS = 16;
+const int MAX_TREES = 16;
+const int MAX_BIRDS = 16;
+const int MAX_BURST_PARTICLES = 512;  // 25 bursts of the largest size
+const int MAX_RAIN_DROPS = 550;       // heaviest rain: 250 + 300 * intensity
+const int MAX_SNOWFLAKES = 236;       // Increase for denser snow
+
+template <typename T>
+bool PoolHasRoom(const std::vector<T>& pool) { return pool.size() < pool.capacity(); }
+
+// ------------ Structures -----------------
+struct Coin { Vector2 position; bool active; Vector2 prevPosition; };
+
+struct Magnet { Vector2 position; bool active; Vector2 prevPosition; };
+
+struct Rock { Vector2 position; bool active; Vector2 prevPosition; };
+
+struct Tree { Vector2 position; float scale; bool active; Vector2 prevPosition; };
+
+struct Particle {
+    Vector2 position, velocity, prevPosition;
+    float life, maxLife;
+    Color color;
+};
+
+struct Ic {
+    Vector2 position, prevPosition;
+    bool active;
+    bool destroyed;
+    float destroyTimer;
+};
+
+struct SnowFlake {
+    float x, y, prevX, prevY;
+    float speedY;
+    float driftX;
+    float size;
+    float opacity;
+};
+
+struct RainDrop {
+    float x, y, speed, length, thickness, opacity, prevX, prevY;
+};
+
+struct Bird { Vector2 position; float speed, scale; bool active; Vector2 prevPosition; };
+
+// ------------ Entity Kernels -----------------
+// The per-entity loops of a tick, shared by the game and bench/bench.cpp.
+Color LerpColor(Color color1, Color color2, float t);
+float Distance(Vector2 a, Vector2 b);
+Vector2 Normalize(Vector2 v);
+
+// Steps a box at pos (half = half its size) towards target when its center is within radius
+void MagnetPull(Vector2& pos, Vector2 half, Vector2 target, float radius, float step);
+// The same pull for a field of coin centers kept as x and y arrays, padded to a
+// multiple of 4 and 16-byte aligned, plus a scroll to the left; four coins per
+// step where SSE is there. Writes the indices of coins within pickupRadius
+// (collected) or left of leftEdge (dropped) to gone, ascending, and sets
+// *picked to the collected count, with where each was in pickedAt. Returns the
+// gone count. The SSE estimate of 1/sqrt differs between CPU vendors, so a
+// seeded replay through it is exact on the same kind of CPU only.
+int PullCoinField(float* x, float* y, int count, Vector2 target, float pull, float scroll,
+                  float pickupRadius, float leftEdge, int* gone, Vector2* pickedAt, int* picked);
+
+void SpawnCoinBurst(std::vector<Particle>& burstParticles, Vector2 pos);
+void UpdateBurstParticles(std::vector<Particle>& burstParticles, float dt);
+// Only the first count entries move (the rest are skipped at lower quality)
+void UpdateSnowflakes(std::vector<SnowFlake>& snowflakes, int count, float dt);
+void UpdateRainDrops(std::vector<RainDrop>& rainDrops, int count, float dt);
+
+// True if area comes within margin of any active entity of the given size (placement scans)
+template <typename T>
+bool OverlapsAnyActive(const std::vector<T>& pool, Rectangle area, Vector2 size, Vector2 margin, const T* skip = nullptr) {
+    for (const T& e : pool) {
+        if (!e.active || &e == skip) continue;
+        if (area.x < e.position.x + size.x + margin.x && area.x + area.width > e.position.x - margin.x &&
+            area.y < e.position.y + size.y + margin.y && area.y + area.height > e.position.y - margin.y) return true;
+    }
+    return false;
+}
@@ -0,0 +1,353 @@
+#include "ghost.h"
+#include "raylib.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MakeDir(path) mkdir(path, 0755)
+#endif
+
+#define GHOST_MAGIC 0x48474753u        // "SGGH"
+#define GHOST_VERSION 1
+#define GHOST_RECORD_BYTES (256 * 1024) // about two hours of play
+
+#pragma pack(push, 4)
+struct GhostHeader {
+    uint32_t magic;
+    uint16_t version, tickRate;
+    uint32_t ticks, dataBytes;
+    int32_t score;
+    int16_t y0;
+    uint8_t frame0, reserved;
+    uint16_t speed0, reserved2;
+    char name[24];
+};
+#pragma pack(pop)
+
+enum { CHANGE_DDY = 1, CHANGE_FRAME = 2, CHANGE_SPEED = 4 };
+
+// ------------ Codec --------------
+static void PutVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+static uint32_t Zigzag(int v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int Unzigzag(uint32_t v) { return (int)(v >> 1) ^ -(int)(v & 1); }
+
+static bool GetVarint(const std::vector<uint8_t>& in, size_t& at, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; at < in.size() && shift < 35; shift += 7) {
+        uint8_t b = in[at++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+struct GhostState {
+    int y, dy, ddy, frame, speed10;
+};
+
+// ------------ Recorder --------------
+static std::vector<uint8_t> recorded;
+static GhostHeader recordHeader;
+static GhostState recordState;
+static uint32_t recordRun = 0;
+static bool recordFull = false;
+static bool raceActive = false; // off until a race starts, and for a resumed run
+
+void GhostRecordBegin() {
+    recorded.clear();
+    memset(&recordHeader, 0, sizeof(recordHeader));
+    recordRun = 0;
+    recordFull = false;
+}
+
+void GhostRecordTick(float y, int frameCode, float scroll) {
+    if (!raceActive) return;
+    int qy = (int)lroundf(y), qspeed = (int)lroundf(scroll * 10.0f);
+    if (recordHeader.ticks == 0) {
+        recordHeader.y0 = (int16_t)qy;
+        recordHeader.frame0 = (uint8_t)frameCode;
+        recordHeader.speed0 = (uint16_t)qspeed;
+        recordState = { qy, 0, 0, frameCode, qspeed };
+    }
+    recordHeader.ticks++;
+    if (recordFull) return;
+    GhostState& s = recordState;
+    int dy = qy - s.y, ddy = dy - s.dy;
+    int mask = (ddy != s.ddy ? CHANGE_DDY : 0) | (frameCode != s.frame ? CHANGE_FRAME : 0) | (qspeed != s.speed10 ? CHANGE_SPEED : 0);
+    if (mask != 0) {
+        if (recorded.size() + 16 > recorded.capacity()) { recordFull = true; return; } // stays allocation free
+        PutVarint(recorded, (recordRun << 3) | mask);
+        if (mask & CHANGE_DDY) PutVarint(recorded, Zigzag(ddy));
+        if (mask & CHANGE_FRAME) recorded.push_back((uint8_t)frameCode);
+        if (mask & CHANGE_SPEED) PutVarint(recorded, Zigzag(qspeed - s.speed10));
+        recordRun = 0;
+    } else {
+        recordRun++;
+    }
+    s = { qy, dy, ddy, frameCode, qspeed };
+}
+
+// ------------ Playback --------------
+struct Ghost {
+    GhostHeader header;
+    std::vector<uint8_t> data;
+    size_t cursor;
+    uint32_t played, pendingRun;
+    int pendingMask, pendingDdy, pendingFrame, pendingSpeed;
+    bool havePending;
+    GhostState state;
+    float prevDistance, distance;
+    int prevY;
+};
+
+struct GhostBank {
+    Ghost ghosts[MAX_GHOSTS];
+    int count;
+};
+
+static GhostBank banks[2];
+static GhostBank* front = &banks[0];   // played by the game thread
+static GhostBank* back = &banks[1];    // filled by the loader thread
+static std::atomic<bool> backReady(false);
+static bool loadInFlight = false, ghostsDirty = true;
+static uint32_t raceTick = 0;
+static float playerPrevDistance = 0.0f, playerDistance = 0.0f;
+
+static void Rewind(Ghost& g) {
+    g.cursor = 0;
+    g.played = 0;
+    g.havePending = false;
+    g.state = { g.header.y0, 0, 0, g.header.frame0, g.header.speed0 };
+    g.prevY = g.state.y;
+    g.prevDistance = g.distance = 0.0f;
+}
+
+static void Step(Ghost& g) {
+    if (g.played >= g.header.ticks) return;
+    if (!g.havePending) {
+        uint32_t token;
+        if (GetVarint(g.data, g.cursor, token)) {
+            g.pendingRun = token >> 3;
+            g.pendingMask = token & 7;
+            uint32_t v = 0;
+            if ((g.pendingMask & CHANGE_DDY) && GetVarint(g.data, g.cursor, v)) g.pendingDdy = Unzigzag(v);
+            if ((g.pendingMask & CHANGE_FRAME) && g.cursor < g.data.size()) g.pendingFrame = g.data[g.cursor++];
+            if ((g.pendingMask & CHANGE_SPEED) && GetVarint(g.data, g.cursor, v)) g.pendingSpeed = g.state.speed10 + Unzigzag(v);
+        } else {
+            g.pendingRun = 0xFFFFFFFFu; // out of changes: the rest of the run repeats the last state
+            g.pendingMask = 0;
+        }
+        g.havePending = true;
+    }
+    GhostState& s = g.state;
+    if (g.pendingRun > 0) {
+        g.pendingRun--;
+    } else {
+        if (g.pendingMask & CHANGE_DDY) s.ddy = g.pendingDdy;
+        if (g.pendingMask & CHANGE_FRAME) s.frame = g.pendingFrame;
+        if (g.pendingMask & CHANGE_SPEED) s.speed10 = g.pendingSpeed;
+        g.havePending = false;
+    }
+    g.prevY = s.y;
+    s.dy += s.ddy;
+    s.y += s.dy;
+    g.prevDistance = g.distance;
+    g.distance += s.speed10 / 10.0f;
+    g.played++;
+}
+
+static void AdoptLoadedBank() {
+    std::swap(front, back);
+    backReady.store(false);
+    loadInFlight = false;
+}
+
+// ------------ Loader / Writer Thread --------------
+struct GhostSaveJob {
+    GhostHeader header;
+    std::vector<uint8_t> data;
+    long long id;
+};
+
+static std::thread worker;
+static std::mutex jobLock;
+static std::condition_variable jobWake;
+static std::vector<GhostSaveJob> saveJobs;
+static bool loadRequested = false, stopping = false;
+
+static bool ReadGhostFile(const char* path, Ghost& g, bool headerOnly) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    bool ok = fread(&g.header, sizeof(g.header), 1, f) == 1 && g.header.magic == GHOST_MAGIC
+        && g.header.version == GHOST_VERSION && g.header.dataBytes <= GHOST_RECORD_BYTES;
+    if (ok && !headerOnly) {
+        g.data.resize(g.header.dataBytes);
+        ok = g.header.dataBytes == 0 || fread(g.data.data(), g.header.dataBytes, 1, f) == 1;
+    }
+    fclose(f);
+    return ok;
+}
+
+// Reads the best MAX_GHOSTS runs of GHOST_DIR into the back bank
+static void LoadBank() {
+    back->count = 0;
+    if (!DirectoryExists(GHOST_DIR)) { backReady.store(true); return; }
+    FilePathList files = LoadDirectoryFilesEx(GHOST_DIR, ".ghost", false);
+    std::vector<std::pair<int, unsigned int>> ranked; // (score, file)
+    Ghost probe;
+    for (unsigned int i = 0; i < files.count; i++)
+        if (ReadGhostFile(files.paths[i], probe, true)) ranked.push_back({ probe.header.score, i });
+    std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<int, unsigned int>& a, const std::pair<int, unsigned int>& b) { return a.first > b.first; });
+    for (const auto& r : ranked) {
+        if (back->count == MAX_GHOSTS) break;
+        Ghost& g = back->ghosts[back->count];
+        if (!ReadGhostFile(files.paths[r.second], g, false)) continue;
+        Rewind(g);
+        back->count++;
+    }
+    UnloadDirectoryFiles(files);
+    backReady.store(true); // release: the bank is complete before the game sees the flag
+}
+
+static void WriteGhostFile(const GhostSaveJob& job) {
+    MakeDir(GHOST_DIR);
+    char path[64];
+    snprintf(path, sizeof(path), "%s/run%lld.ghost", GHOST_DIR, job.id);
+    FILE* f = fopen(path, "wb");
+    if (!f) return;
+    fwrite(&job.header, sizeof(job.header), 1, f);
+    if (!job.data.empty()) fwrite(job.data.data(), job.data.size(), 1, f);
+    fclose(f);
+}
+
+static void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(jobLock);
+    for (;;) {
+        jobWake.wait(lock, [] { return stopping || loadRequested || !saveJobs.empty(); });
+        if (!saveJobs.empty()) {
+            std::vector<GhostSaveJob> jobs;
+            jobs.swap(saveJobs);
+            lock.unlock();
+            for (const GhostSaveJob& job : jobs) WriteGhostFile(job);
+            lock.lock();
+            continue; // saves go first, so a reload right after sees them
+        }
+        if (stopping) return;
+        loadRequested = false;
+        lock.unlock();
+        LoadBank();
+        lock.lock();
+    }
+}
+
+static void RequestLoad() {
+    {
+        std::lock_guard<std::mutex> lock(jobLock);
+        loadRequested = true;
+    }
+    loadInFlight = true;
+    ghostsDirty = false;
+    jobWake.notify_one();
+}
+
+void GhostsInit() {
+    recorded.reserve(GHOST_RECORD_BYTES);
+    stopping = false;
+    worker = std::thread(WorkerLoop);
+    RequestLoad();
+}
+
+void GhostsShutdown() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(jobLock);
+        stopping = true;
+        loadRequested = false;
+    }
+    jobWake.notify_one();
+    worker.join();
+}
+
+void GhostRecordSave(const char* name, int score, long long id) {
+    if (!worker.joinable() || !raceActive || recordHeader.ticks == 0) return;
+    GhostSaveJob job;
+    job.header = recordHeader;
+    job.header.magic = GHOST_MAGIC;
+    job.header.version = GHOST_VERSION;
+    job.header.tickRate = 60;
+    job.header.dataBytes = (uint32_t)recorded.size();
+    job.header.score = score;
+    strncpy(job.header.name, name, sizeof(job.header.name) - 1);
+    job.data = recorded;
+    job.id = id;
+    {
+        std::lock_guard<std::mutex> lock(jobLock);
+        saveJobs.push_back(std::move(job));
+    }
+    ghostsDirty = true;
+    jobWake.notify_one();
+}
+
+void GhostsBeginRace() {
+    if (backReady.load()) AdoptLoadedBank();
+    if (ghostsDirty && !loadInFlight && worker.joinable()) RequestLoad();
+    for (int i = 0; i < front->count; i++) Rewind(front->ghosts[i]);
+    raceTick = 0;
+    raceActive = true;
+    playerPrevDistance = playerDistance = 0.0f;
+}
+
+void GhostsAbandonRace() {
+    raceActive = false;
+}
+
+void GhostsTick() {
+    if (!raceActive) return;
+    raceTick++;
+    playerPrevDistance = playerDistance;
+    playerDistance += recordState.speed10 / 10.0f;
+    // The first set of a session may arrive mid-race; it catches up to the race clock
+    if (front->count == 0 && backReady.load()) {
+        AdoptLoadedBank();
+        for (int i = 0; i < front->count; i++) {
+            Rewind(front->ghosts[i]);
+            for (uint32_t t = 1; t < raceTick; t++) Step(front->ghosts[i]);
+        }
+    }
+    for (int i = 0; i < front->count; i++) Step(front->ghosts[i]);
+}
+
+int GhostsCollect(GhostDraw* out, int max) {
+    if (!raceActive) return 0;
+    int perFrame[8] = {};
+    for (int i = 0; i < front->count; i++) {
+        const Ghost& g = front->ghosts[i];
+        if (g.played > 0 && g.played < g.header.ticks) perFrame[g.state.frame & 7]++;
+    }
+    int start[8], n = 0;
+    for (int f = 0; f < 8; f++) { start[f] = n; n += perFrame[f]; }
+    n = std::min(n, max);
+    for (int i = 0; i < front->count; i++) {
+        const Ghost& g = front->ghosts[i];
+        if (g.played == 0 || g.played >= g.header.ticks) continue;
+        int slot = start[g.state.frame & 7]++;
+        if (slot >= max) continue;
+        out[slot] = { g.prevDistance - playerPrevDistance, g.distance - playerDistance,
+                      (float)g.prevY, (float)g.state.y, (uint8_t)(g.state.frame & 7) };
+    }
+    return n;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+// ------------ Ghost Racing --------------
+// Runs are recorded per tick as (y, animation frame, scroll speed), quantized and
+// delta-coded: only changes of the second difference of y, of the frame and of
+// the speed are written, as varints after a count of unchanged ticks (a couple
+// of KB per minute). Up to MAX_GHOSTS of the best recorded runs are read from
+// GHOST_DIR by a background thread and replayed alongside the player.
+#define GHOST_DIR "ghosts"
+#define MAX_GHOSTS 100
+
+// Frame codes: 0-3 run frames, 4-7 jump frames
+struct GhostDraw {
+    float prevOffset, offset;  // x relative to the player, last and current tick
+    float prevY, y;
+    uint8_t frame;
+};
+
+void GhostsInit();       // starts the loader/writer thread
+void GhostsShutdown();   // finishes queued writes
+
+void GhostRecordBegin();
+void GhostRecordTick(float y, int frameCode, float scroll);
+void GhostRecordSave(const char* name, int score, long long id); // queued, written in the background
+
+void GhostsBeginRace();  // rewinds the loaded ghosts (and adopts a freshly loaded set)
+void GhostsTick();       // one tick of every ghost, after GhostRecordTick
+void GhostsAbandonRace(); // a run resumed midway: no recording, and no ghosts to line up with
+// Ghosts still running, grouped by frame code so draws of one texture are consecutive
+int GhostsCollect(GhostDraw* out, int max);
@@ -0,0 +1,65 @@
+#include "hitmask.h"
+#include <cmath>
+
+HitMask BuildHitMask(Image image, float scale) {
+    HitMask m = { 0, 0, 0, {} };
+    if (image.data == nullptr || image.width <= 0 || image.height <= 0 || scale <= 0.0f) return m;
+    m.cols = (int)ceilf(image.width * scale / HITMASK_CELL);
+    m.rows = (int)ceilf(image.height * scale / HITMASK_CELL);
+    m.words = (m.cols + 63) / 64;
+    m.bits.assign((size_t)m.rows * m.words, 0);
+
+    Color* texels = LoadImageColors(image);
+    float texelsPerCell = HITMASK_CELL / scale;
+    for (int cy = 0; cy < m.rows; cy++) {
+        int y0 = (int)(cy * texelsPerCell), y1 = (int)ceilf((cy + 1) * texelsPerCell);
+        if (y1 > image.height) y1 = image.height;
+        for (int cx = 0; cx < m.cols; cx++) {
+            int x0 = (int)(cx * texelsPerCell), x1 = (int)ceilf((cx + 1) * texelsPerCell);
+            if (x1 > image.width) x1 = image.width;
+            bool solid = false;
+            for (int y = y0; y < y1 && !solid; y++)
+                for (int x = x0; x < x1; x++)
+                    if (texels[y * image.width + x].a >= HITMASK_ALPHA) { solid = true; break; }
+            if (solid) m.bits[(size_t)cy * m.words + cx / 64] |= 1ull << (cx % 64);
+        }
+    }
+    UnloadImageColors(texels);
+    return m;
+}
+
+HitMask LoadHitMask(const char* fileName, float scale) {
+    Image image = LoadImage(fileName);
+    HitMask m = BuildHitMask(image, scale);
+    if (image.data == nullptr) TraceLog(LOG_WARNING, "HITMASK: [%s] not loaded, using its rectangle", fileName);
+    UnloadImage(image);
+    return m;
+}
+
+// 64 columns of a row starting at `start` (may be negative or past the end)
+static uint64_t RowBits(const HitMask& m, int row, int start) {
+    if (start >= m.cols || start <= -64) return 0;
+    const uint64_t* r = &m.bits[(size_t)row * m.words];
+    int w = start >= 0 ? start / 64 : -((-start + 63) / 64);
+    int shift = start - w * 64;
+    uint64_t lo = (w >= 0 && w < m.words) ? r[w] : 0;
+    uint64_t hi = (w + 1 >= 0 && w + 1 < m.words) ? r[w + 1] : 0;
+    return shift ? (lo >> shift) | (hi << (64 - shift)) : lo;
+}
+
+bool HitMasksOverlap(const HitMask& a, Vector2 aPos, const HitMask& b, Vector2 bPos) {
+    if (a.words == 0 || b.words == 0) return true;
+    // b's origin in a's cells
+    int dx = (int)lroundf((bPos.x - aPos.x) / HITMASK_CELL);
+    int dy = (int)lroundf((bPos.y - aPos.y) / HITMASK_CELL);
+    int rowStart = dy > 0 ? dy : 0;
+    int rowEnd = dy + b.rows < a.rows ? dy + b.rows : a.rows;
+    for (int ra = rowStart; ra < rowEnd; ra++) {
+        const uint64_t* rowA = &a.bits[(size_t)ra * a.words];
+        for (int w = 0; w < a.words; w++) {
+            if (rowA[w] == 0) continue;
+            if (rowA[w] & RowBits(b, ra - dy, w * 64 - dx)) return true;
+        }
+    }
+    return false;
+}
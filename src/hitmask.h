@@ -0,0 +1,24 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <vector>
+
+// ------------ Hit Masks --------------
+// 1-bit alpha masks for pixel-accurate collision. Masks are built at the scale a
+// sprite is drawn, on a shared world grid of HITMASK_CELL pixels, so two masks
+// line up with a shift and rows can be tested with 64-bit ANDs.
+#define HITMASK_CELL 4.0f   // world pixels per mask cell
+#define HITMASK_ALPHA 128   // texels at or above this alpha are solid
+
+struct HitMask {
+    int cols, rows;
+    int words;                    // 64-bit words per row
+    std::vector<uint64_t> bits;   // rows * words; bit c % 64 of word c / 64 is column c
+};
+
+HitMask BuildHitMask(Image image, float scale);
+// Empty mask (fail-open, see HitMasksOverlap) if the image can't be loaded
+HitMask LoadHitMask(const char* fileName, float scale);
+// Narrowphase for sprites drawn at aPos / bPos; call once their rectangles overlap.
+// An empty mask counts as solid so a missing image never disables a hit.
+bool HitMasksOverlap(const HitMask& a, Vector2 aPos, const HitMask& b, Vector2 bPos);
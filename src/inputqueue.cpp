@@ -0,0 +1,63 @@
+#include "inputqueue.h"
+#include <algorithm>
+
+#define INPUT_QUEUE_SIZE 64
+#define INPUT_FRAME_EVENTS 32
+#define INPUT_LATENCY_SAMPLES 128
+
+static InputEvent queue[INPUT_QUEUE_SIZE];
+static int first = 0, queued = 0;
+static double consumedTimes[INPUT_FRAME_EVENTS];
+static int consumedCount = 0;
+static double latencies[INPUT_LATENCY_SAMPLES];
+static int latencyCount = 0, latencyNext = 0;
+
+static void Push(InputEventType type, int value, Vector2 mouse, double time) {
+    if (queued == INPUT_QUEUE_SIZE) return; // a stalled sim drops the newest presses
+    queue[(first + queued++) % INPUT_QUEUE_SIZE] = { type, value, mouse, time };
+}
+
+void InputCollect(double polledAt) {
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) Push(INPUT_CLICK, 0, mouse, polledAt);
+    for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) Push(INPUT_KEY, key, mouse, polledAt);
+    for (int ch = GetCharPressed(); ch != 0; ch = GetCharPressed()) Push(INPUT_CHAR, ch, mouse, polledAt);
+}
+
+bool InputPeek(InputEvent& e) {
+    if (queued == 0) return false;
+    e = queue[first];
+    return true;
+}
+
+void InputPop() {
+    if (queued == 0) return;
+    first = (first + 1) % INPUT_QUEUE_SIZE;
+    queued--;
+}
+
+void InputConsumed(const InputEvent& e) {
+    if (consumedCount < INPUT_FRAME_EVENTS) consumedTimes[consumedCount++] = e.time;
+}
+
+void InputPresented(double now) {
+    for (int i = 0; i < consumedCount; i++) {
+        latencies[latencyNext] = now - consumedTimes[i];
+        latencyNext = (latencyNext + 1) % INPUT_LATENCY_SAMPLES;
+        if (latencyCount < INPUT_LATENCY_SAMPLES) latencyCount++;
+    }
+    consumedCount = 0;
+}
+
+InputLatencyStats InputLatency() {
+    InputLatencyStats s = { latencyCount, 0.0, 0.0, 0.0 };
+    if (latencyCount == 0) return s;
+    double sorted[INPUT_LATENCY_SAMPLES];
+    std::copy(latencies, latencies + latencyCount, sorted);
+    std::sort(sorted, sorted + latencyCount);
+    for (int i = 0; i < latencyCount; i++) s.mean += sorted[i];
+    s.mean /= latencyCount;
+    s.p95 = sorted[(latencyCount * 95) / 100];
+    s.max = sorted[latencyCount - 1];
+    return s;
+}
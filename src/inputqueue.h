@@ -0,0 +1,28 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Input Queue --------------
+// Presses are taken off raylib right after each poll and kept, in order, in a
+// fixed ring; the simulation drains them tick by tick. raylib does not stamp
+// events, so each one carries the time of the poll that delivered it. Every
+// consumed event is timed again when the frame showing its effect is presented.
+enum InputEventType { INPUT_CLICK, INPUT_KEY, INPUT_CHAR };
+
+struct InputEvent {
+    InputEventType type;
+    int value;           // key code or codepoint
+    Vector2 mouse;       // cursor at the poll
+    double time;         // GetTime() of the poll
+};
+
+struct InputLatencyStats {
+    int samples;
+    double mean, p95, max; // seconds from poll to present
+};
+
+void InputCollect(double polledAt);  // after PollInputEvents() (or EndDrawing(), which polls)
+bool InputPeek(InputEvent& e);       // oldest queued event
+void InputPop();
+void InputConsumed(const InputEvent& e); // the simulation acted on it this frame
+void InputPresented(double now);         // the frame is on screen: closes its latency samples
+InputLatencyStats InputLatency();        // over the last INPUT_LATENCY_SAMPLES events
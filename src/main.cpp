@@ -1,16 +1,42 @@
 #include "raylib.h"
+#include "render.h"
+#include "entities.h"
+#include "uicache.h"
+#include "compositor.h"
+#include "pacing.h"
+#include "resscale.h"
+#include "quality.h"
+#include "arena.h"
+#include "memtrack.h"
+#include "hitmask.h"
+#include "sweep.h"
+#include "scenario.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "scorestore.h"
+#include "ghost.h"
+#include "simrng.h"
+#include "snapshot.h"
+#include "rewind.h"
+#include "videoexport.h"
+#include "inputqueue.h"
+#include "spritequeue.h"
+#include "textcache.h"
+#include "assets.h"
+#include "archetypes.h"
+#include "coinrush.h"
 #include <vector>
 #include <cmath>
-#include <random>
 #include <fstream>
 #include <string>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <ctime>
 
 // ------------ Game Constants & UI ---------------
-#define SCREEN_WIDTH 1500
-#define SCREEN_HEIGHT 800
 #define GROUND_Y 775
 #define PLAYER_X 250
 #define PLAYER_SPEED 10.0f
@@ -59,6 +85,7 @@ Rectangle tapToStartRect = {
 };
 
 
+bool savesEnabled = true; // off for --check runs so they never touch the player's files
 
 void LoadUpgrades() {
     std::ifstream f(UPGRADE_FILE);
@@ -66,6 +93,7 @@ void LoadUpgrades() {
     else { maxHealth = 100; maxMana = 100; bankaiCooldownUpgrade = 0; bankaiManaCostUpgrade = 0; selectedSkin = 0; }
 }
 void SaveUpgrades() {
+    if (!savesEnabled) return;
     std::ofstream f(UPGRADE_FILE);
     f << maxHealth << " " << maxMana << " " << bankaiCooldownUpgrade << " " << bankaiManaCostUpgrade << " " << selectedSkin;
 }
@@ -81,26 +109,61 @@ int getBankaiCost() {
 }
 
 // ------------- High Score Table ----------------
+// Every run goes into the score store (scores.db); highScores mirrors its top
+// entries for the panel.
 #define MAX_HIGHSCORES 5
 #define MAX_NAME_LEN 20
+#define SCORE_STORE_FILE "scores.db"
+#define LEGACY_HIGHSCORE_FILE "highscores.txt"
 struct HighScoreEntry { char name[MAX_NAME_LEN + 1]; int score; };
 HighScoreEntry highScores[MAX_HIGHSCORES];
 char nameInput[MAX_NAME_LEN + 1] = "";
 bool waitingNameInput = false;
-int insertIndex = -1;
-void LoadHighScores() {
-    std::ifstream in("highscores.txt");
+long long insertIndex = -1;               // store record waiting for its name
+long long lastRunRank = 0, lastRunTotal = 0;
+void RefreshHighScores() {
+    ScoreRecord top[MAX_HIGHSCORES];
+    int n = ScoreStoreTop(top, MAX_HIGHSCORES);
     for (int i = 0; i < MAX_HIGHSCORES; i++) {
-        if (!(in >> highScores[i].name >> highScores[i].score)) {
+        if (i < n) {
+            strncpy(highScores[i].name, top[i].name, MAX_NAME_LEN);
+            highScores[i].name[MAX_NAME_LEN] = '\0';
+            highScores[i].score = top[i].score;
+        } else {
             strcpy(highScores[i].name, "---");
             highScores[i].score = 0;
         }
     }
 }
-void SaveHighScores() {
-    std::ofstream out("highscores.txt");
-    for (int i = 0; i < MAX_HIGHSCORES; i++)
-        out << highScores[i].name << " " << highScores[i].score << std::endl;
+// The old top-five text file, imported once into an empty store. The score is
+// the last field of a line, so names holding spaces come through whole.
+void ImportLegacyHighScores() {
+    std::ifstream in(LEGACY_HIGHSCORE_FILE);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t cut = line.find_last_of(' ');
+        if (cut == std::string::npos) continue;
+        std::string name = line.substr(0, cut);
+        int score = atoi(line.c_str() + cut + 1);
+        if (score > 0 && name != "---") ScoreStoreAdd(score, name.c_str());
+    }
+}
+void LoadHighScores() {
+    if (savesEnabled && ScoreStoreOpen(SCORE_STORE_FILE) && ScoreStoreCount() == 0) ImportLegacyHighScores();
+    RefreshHighScores();
+}
+// Books a finished run; one that makes the table asks for a name at game over
+void RecordRun(int score) {
+    long long place = ScoreStorePlace(score);
+    lastRunRank = ScoreStoreRank(score);
+    long long index = ScoreStoreAdd(score, "");
+    lastRunTotal = ScoreStoreCount();
+    RefreshHighScores();
+    if (index >= 0 && score > 0 && place <= MAX_HIGHSCORES) {
+        insertIndex = index;
+        waitingNameInput = true;
+        strcpy(nameInput, "");
+    }
 }
 
 // ------------ Sound Toggle --------------
@@ -114,10 +177,11 @@ void LoadSoundState() {
     isSoundOn = (val == 1);
 }
 void SaveSoundState() {
+    if (!savesEnabled) return;
     std::ofstream f(SOUND_STATE_FILE);
     f << (isSoundOn ? 1 : 0);
 }
-#define PLAY_SOUND(snd) do { if (isSoundOn) PlaySound(snd); } while(0)
+#define PLAY_SOUND(snd) do { if (isSoundOn) { PlaySound(snd); AssetTouchSound(snd); } } while(0)
 
 bool isPaused = false;
 Texture2D pauseIcon, resumeIcon;
@@ -127,49 +191,206 @@ Rectangle pauseRect;
 enum AppState {
     MENU, STANDUP, GAME, SHOP, HIGH_SCORE,
     ZEN_TRANSITION, ZEN_MODE, ZEN_TRANSITION_BACK,
-    GAME_OVER_STATE
+    GAME_OVER_STATE,
+    APP_STATE_COUNT
 };
 AppState currentState = MENU;
+const char* appStateNames[APP_STATE_COUNT] = {
+    "MENU", "STANDUP", "GAME", "SHOP", "HIGH_SCORE",
+    "ZEN_TRANSITION", "ZEN_MODE", "ZEN_TRANSITION_BACK",
+    "GAME_OVER"
+};
 const char* workshopText = "Workshop";
 const char* highScoreText = "High Score";
 
-// ------------ Structures -----------------
-struct Coin { Vector2 position; bool active; };
-
-struct Magnet { Vector2 position; bool active; };
-
-struct Rock { Vector2 position; bool active; };
-
-struct Tree { Vector2 position; float scale; bool active; };
-
-struct Particle {
-    Vector2 position, velocity;
-    float life, maxLife;
-    Color color;
+// ----------- Idle Throttling -----------
+// Screens where nothing moves on its own are redrawn only when input arrives,
+// or at IDLE_FPS while music plays so its stream keeps being fed.
+#define IDLE_FPS 10
+#define IDLE_AUDIO_BUFFER 8192 // frames per music buffer half, outlasts an idle frame at 44.1 kHz
+long long audioUnderruns = 0;  // frames longer than a music buffer half: the stream ran dry
+bool idleThrottle = true;      // off with --null-render / --no-idle
+bool idleFrame = false;
+
+// ------------ Render Stats & Budgets --------------
+// Max draw commands per frame for each AppState; checked by the --null-render run.
+const int drawCallBudget[APP_STATE_COUNT] = {
+    40, 40, 1200, 80, 40,
+    40, 40, 40,
+    60
 };
-
-struct Ic {
-    Vector2 position;
-    bool active;
-    bool destroyed;
-    float destroyTimer;
+struct StateRenderStats {
+    int frames, overBudgetFrames;
+    long long drawCalls;
+    int maxDrawCalls, maxTextureSwitches;
+    double overdraw;
+    long long fullscreenDeclared, fullscreenDrawn;
+    long long spritesQueued, spritesCulled;
 };
+StateRenderStats stateRenderStats[APP_STATE_COUNT];
+RenderStats lastRenderStats;
+CompositorStats lastCompositorStats; // reset every frame, filled when the GAME layers are flushed
+SpriteQueueStats lastSpriteStats;     // likewise, filled when the GAME sprites are flushed
+
+// Draw order of the queued gameplay sprites; within a layer they are grouped by texture,
+// so only sprites whose order does not matter share one. Obstacles go last, nothing hides them.
+enum SpriteLayer { LAYER_SKY, LAYER_SCENERY, LAYER_PICKUPS, LAYER_OBSTACLES };
+RenderStats worldRenderStats;         // world pass of the frame when it went through the scaled target
+bool worldPassUsed = false;
+
+// Draws the world recorded so far through the dynamic resolution target; what
+// is recorded after this (the HUD) stays at native resolution
+void ResolveWorldPass() {
+    if (!ResScaleEnabled() || worldPassUsed) return;
+    ProfEnter(PROF_FLUSH);
+    worldRenderStats = ResScaleFlushWorld();
+    worldPassUsed = true;
+    ProfEnter(PROF_RECORD);
+}
+bool showRenderStats = false; // F3
+bool showAssets = false;      // F4
+
+// Heap use measured by memtrack; frames after the warm-up are the steady state
+#define ALLOC_WARMUP_FRAMES 600
+long long framesEnded = 0;
+long long steadyAllocs = 0, steadyAllocBytes = 0;
+long long maxFrameAllocs = 0;
+MemCounters lastFrameAllocs;
+
+void DrawRenderStatsOverlay() {
+    const RenderStats& s = lastRenderStats;
+    CmdRectangle(SCREEN_WIDTH - 330, SCREEN_HEIGHT - 300, 310, 280, (Color){0, 0, 0, 150});
+    InputLatencyStats il = InputLatency();
+    CmdText(TextFormat("input->present %.1f ms  p95 %.1f  max %.1f", il.mean * 1000.0, il.p95 * 1000.0, il.max * 1000.0),
+        SCREEN_WIDTH - 320, SCREEN_HEIGHT - 265, 20, RAYWHITE);
+    CmdText(TextFormat("heap allocs %lld (%lld B)  steady %lld", lastFrameAllocs.allocs, lastFrameAllocs.bytes, steadyAllocs),
+        SCREEN_WIDTH - 320, SCREEN_HEIGHT - 240, 20, RAYWHITE);
+    CpuUsage cu = PacerCpuUsage();
+    CmdText(TextFormat("cpu active %.0f%%  idle %.0f%%", cu.activeWall > 0.0 ? 100.0 * cu.activeCpu / cu.activeWall : 0.0,
+        cu.idleWall > 0.0 ? 100.0 * cu.idleCpu / cu.idleWall : 0.0), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 215, 20, RAYWHITE);
+    PresentStats ps = PacerPresentStats();
+    CmdText(TextFormat("present %.2f ms  jitter %.2f  max %.1f", ps.meanInterval * 1000.0, ps.jitter * 1000.0,
+        ps.worstInterval * 1000.0), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 190, 20, RAYWHITE);
+    CmdText(TextFormat("work %.1f ms  res %.0f%%%s  %s", PacerWorkTime() * 1000.0, ResScaleGetScale() * 100.0f,
+        ResScaleGetSharpen() ? " sharp" : "", QualityLevelName(QualityGetLevel())), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 165, 20, RAYWHITE);
+    CmdText(TextFormat("draws %d  tex switches %d", s.drawCalls, s.textureSwitches), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 140, 20, RAYWHITE);
+    CmdText(TextFormat("tex %d  text %d  rect %d", s.primitives[RC_TEXTURE_PRO] + s.primitives[RC_TEXTURE_EX] + s.primitives[RC_TEXTURE_PREMUL]
+        + s.primitives[RC_TEXTURE_BATCH],
+        s.primitives[RC_TEXT], s.primitives[RC_RECT] + s.primitives[RC_RECT_LINES]), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 115, 20, RAYWHITE);
+    CmdText(TextFormat("circle %d  line %d", s.primitives[RC_CIRCLE], s.primitives[RC_LINE]), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 90, 20, RAYWHITE);
+    CmdText(TextFormat("overdraw %.2fx", s.overdraw), SCREEN_WIDTH - 320, SCREEN_HEIGHT - 65, 20, RAYWHITE);
+    CmdText(TextFormat("sprites %d  culled %d  of %d", lastSpriteStats.submitted, lastSpriteStats.culled, lastSpriteStats.queued),
+        SCREEN_WIDTH - 320, SCREEN_HEIGHT - 290, 20, RAYWHITE);
+    const CompositorStats& c = lastCompositorStats;
+    CmdText(TextFormat("full-screen %d of %d", c.layersDrawn, c.layersDeclared),
+        SCREEN_WIDTH - 320, SCREEN_HEIGHT - 40, 20, RAYWHITE);
+}
 
-struct SnowFlake {
-    float x, y;
-    float speedY;
-    float driftX;
-    float size;
-    float opacity;
-};
-std::vector<SnowFlake> snowflakes;
-const int MAX_SNOWFLAKES = 236; // Increase for denser snow
+// Pool totals against their budgets and the largest assets (F4)
+void DrawAssetOverlay() {
+    const int rows = 10;
+    CmdRectangle(20, SCREEN_HEIGHT - 80 - rows * 25, 560, 70 + rows * 25, (Color){0, 0, 0, 150});
+    int y = SCREEN_HEIGHT - 70 - rows * 25;
+    for (int p = 0; p < ASSET_POOL_COUNT; p++, y += 25) {
+        AssetPoolStats ps = AssetGetPoolStats((AssetPool)p);
+        CmdText(TextFormat("%s %.1f / %.0f MB  %d assets  peak %.1f", AssetPoolName((AssetPool)p), ps.bytes / 1048576.0,
+            ps.budget / 1048576.0, ps.count, ps.peakBytes / 1048576.0), 30, y, 20,
+            ps.budget > 0 && ps.bytes > ps.budget ? RED : RAYWHITE);
+    }
+    const AssetInfo* largest[rows];
+    int n = AssetsLargest(largest, rows);
+    for (int i = 0; i < n; i++, y += 25) {
+        const AssetInfo& a = *largest[i];
+        CmdText(TextFormat("%7.0f KB %-6s %s %s", a.bytes / 1024.0, a.owner, a.name,
+            a.lastUse < 0 ? "(unused)" : TextFormat("(%lld ago)", AssetsFrame() - a.lastUse)), 30, y, 20, RAYWHITE);
+    }
+}
 
-struct RainDrop {
-    float x, y, speed, length, thickness, opacity;
-};
+// Flushes the recorded frame through the active backend and books its stats
+void EndFrame() {
+    if (showRenderStats) DrawRenderStatsOverlay();
+    if (showAssets) DrawAssetOverlay();
+    ProfEnter(PROF_FLUSH);
+    lastRenderStats = RenderFlush();
+    if (worldPassUsed) AddRenderStats(lastRenderStats, worldRenderStats);
+    StateRenderStats& st = stateRenderStats[currentState];
+    st.frames++;
+    st.drawCalls += lastRenderStats.drawCalls;
+    st.overdraw += lastRenderStats.overdraw;
+    st.fullscreenDeclared += lastCompositorStats.layersDeclared;
+    st.fullscreenDrawn += lastCompositorStats.layersDrawn;
+    st.spritesQueued += lastSpriteStats.queued;
+    st.spritesCulled += lastSpriteStats.culled;
+    if (lastRenderStats.drawCalls > st.maxDrawCalls) st.maxDrawCalls = lastRenderStats.drawCalls;
+    if (lastRenderStats.textureSwitches > st.maxTextureSwitches) st.maxTextureSwitches = lastRenderStats.textureSwitches;
+    if (lastRenderStats.drawCalls > drawCallBudget[currentState]) st.overBudgetFrames++;
+    if (ExportActive()) {
+        Image shot = LoadImageFromScreen(); // the finished frame, before it is presented
+        ExportFrame((unsigned char*)shot.data, shot.width, shot.height);
+    }
+    // Without music nothing needs feeding, so raylib can block in EndDrawing() until an event
+    if (idleFrame && !isSoundOn) EnableEventWaiting(); else DisableEventWaiting();
+    PacerSetIdle(idleFrame, isSoundOn ? IDLE_FPS : 0);
+    PacerEndWork(); // the governors below must not count the vsync wait as load
+    ProfEnter(PROF_PRESENT);
+    EndDrawing();
+    double presentedAt = GetTime();
+    InputPresented(presentedAt);
+    InputCollect(presentedAt); // EndDrawing() polled; its presses are gone by the next poll
+    ProfFrameEnd();
+    AssetsEndFrame();
+    PacerEndFrame();
+    lastFrameAllocs = MemFrameCounters();
+    if (++framesEnded == ALLOC_WARMUP_FRAMES) ProfReset(); // timings cover the steady state too
+    if (framesEnded > ALLOC_WARMUP_FRAMES) {
+        steadyAllocs += lastFrameAllocs.allocs;
+        steadyAllocBytes += lastFrameAllocs.bytes;
+        if (lastFrameAllocs.allocs > maxFrameAllocs) maxFrameAllocs = lastFrameAllocs.allocs;
+    }
+    MemSetTag(MEM_TAG_OTHER);
+    // Idle frames say nothing about load (and may have blocked waiting for events)
+    if (!idleFrame) {
+        if (worldPassUsed) ResScaleUpdate(PacerWorkTime(), PacerFrameBudget());
+        if (currentState == GAME) QualityUpdate(PacerWorkTime(), PacerFrameBudget());
+    }
+    worldPassUsed = false;
+}
+
+// Prints per-state draw stats, returns false if any state went over its budget
+bool PrintRenderReport() {
+    bool ok = true;
+    printf("%-20s %7s %9s %9s %9s %9s %7s\n", "state", "frames", "avg draws", "max draws", "budget", "max tex", "over");
+    for (int i = 0; i < APP_STATE_COUNT; i++) {
+        const StateRenderStats& st = stateRenderStats[i];
+        if (st.frames == 0) continue;
+        printf("%-20s %7d %9.1f %9d %9d %9d %7d  overdraw %.2fx", appStateNames[i], st.frames,
+            (double)st.drawCalls / st.frames, st.maxDrawCalls, drawCallBudget[i], st.maxTextureSwitches,
+            st.overBudgetFrames, st.overdraw / st.frames);
+        if (st.fullscreenDeclared > 0)
+            printf("  full-screen passes %.1f of %.1f", (double)st.fullscreenDrawn / st.frames, (double)st.fullscreenDeclared / st.frames);
+        if (st.spritesQueued > 0)
+            printf("  sprites culled %.1f of %.1f", (double)st.spritesCulled / st.frames, (double)st.spritesQueued / st.frames);
+        printf("\n");
+        if (st.overBudgetFrames > 0) ok = false;
+    }
+    PresentStats ps = PacerPresentStats();
+    printf("present interval %.2f ms, jitter %.2f ms, worst %.2f ms (last %d frames)\n",
+        ps.meanInterval * 1000.0, ps.jitter * 1000.0, ps.worstInterval * 1000.0, ps.samples);
+    printf("heap: %lld allocations (%lld bytes) after %d warm-up frames, worst frame %lld\n",
+        steadyAllocs, steadyAllocBytes, ALLOC_WARMUP_FRAMES, maxFrameAllocs);
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        MemCounters mc = MemTotalCounters((MemTag)t);
+        if (mc.allocs > 0) printf("  %-10s %8lld allocs %10lld bytes since start\n", MemTagName((MemTag)t), mc.allocs, mc.bytes);
+    }
+    CpuUsage cu = PacerCpuUsage();
+    printf("cpu: active %.1f%% of %.1f s, idle %.1f%% of %.1f s\n",
+        cu.activeWall > 0.0 ? 100.0 * cu.activeCpu / cu.activeWall : 0.0, cu.activeWall,
+        cu.idleWall > 0.0 ? 100.0 * cu.idleCpu / cu.idleWall : 0.0, cu.idleWall);
+    return ok;
+}
 
-struct Bird { Vector2 position; float speed, scale; bool active; };
+// ------------ Weather & Birds -----------------
+std::vector<SnowFlake> snowflakes;
 std::vector<Bird> birds;
 Texture2D birdTexture;
 
@@ -186,6 +407,33 @@ bool rainSoundPlaying = false;
 float thunderTimer = 0.0f, thunderInterval = 0.0f;
 float timeSinceGameStarted = 0.0f;
 
+// Begins a rain period at the given intensity (0 - 1)
+void StartRain(float intensity) {
+    raining = true;
+    rainState = 1;
+    rainTimer = 0.0f;
+    rainIntensity = intensity;
+    rainDrops.clear();
+    MemScope scope(MEM_TAG_WEATHER);
+    int dropCount = 250 + (int)(rainIntensity * 300);
+    if (dropCount > MAX_RAIN_DROPS) dropCount = MAX_RAIN_DROPS;
+    for (int i = 0; i < dropCount; i++) {
+        RainDrop r;
+        r.x = (float)SimRandomValue(0, SCREEN_WIDTH);
+        r.y = (float)SimRandomValue(0, SCREEN_HEIGHT);
+        r.prevX = r.x; r.prevY = r.y;
+        r.length = 16 + rainIntensity * SimRandomValue(8, 32);
+        r.thickness = 1 + rainIntensity * SimRandomValue(1, 2);
+        r.opacity = 0.45f + rainIntensity * 0.45f;
+        r.speed = 600 + rainIntensity * SimRandomValue(100, 500);
+        rainDrops.push_back(r);
+    }
+    PLAY_SOUND(rainSnd);
+    rainSoundPlaying = true;
+    thunderInterval = 2.0f + ((float)SimRandomValue(0, 300) / 100.0f);
+    thunderTimer = 0.0f;
+}
+
 // ------------ Persistent Storage -----------------
 const char* COIN_FILE = "coin.txt";
 const char* HIGH_SCORE_FILE = "highscore.txt";
@@ -195,6 +443,7 @@ void LoadStats() {
     std::ifstream scoreFile(HIGH_SCORE_FILE); if (scoreFile) scoreFile >> highScore; scoreFile.close();
 }
 void SaveStats() {
+    if (!savesEnabled) return;
     std::ofstream coinFile(COIN_FILE); coinFile << totalCoins; coinFile.close();
     std::ofstream scoreFile(HIGH_SCORE_FILE); scoreFile << highScore; scoreFile.close();
 }
@@ -205,6 +454,11 @@ Texture2D coinTexture, magnetTexture, rockTexture, treeTexture, icTexture, icDes
 Texture2D healthTexture, manaTexture;
 std::vector<Texture2D> playerFrames;
 Texture2D jumpFrames[4];
+const float PLAYER_SCALE = 0.4f;
+const float BIRD_SCALE = ARCHETYPES[ARCH_BIRD].factor;
+// Collision masks at draw scale: per player frame (rebuilt with the skin) and per obstacle
+HitMask playerRunMasks[4], playerJumpMasks[4];
+HitMask rockMask, birdMask, icMask;
 const int NUM_STANDUP_FRAMES = 4;
 Texture2D standUpFrames[NUM_STANDUP_FRAMES];
 int standUpCurrentFrame = 0;
@@ -220,78 +474,79 @@ Rectangle exitRect;
 
 // ======== SKIN LOADING ==========
 void LoadSkin(int skin) {
-    if (!playerFrames.empty()) for (auto& t : playerFrames) UnloadTexture(t);
-    for (int i = 0; i < 4; i++) UnloadTexture(jumpFrames[i]);
-    for (int i = 0; i < NUM_STANDUP_FRAMES; i++) UnloadTexture(standUpFrames[i]);
+    if (!playerFrames.empty()) for (auto& t : playerFrames) AssetUnloadTexture(t);
+    for (int i = 0; i < 4; i++) AssetUnloadTexture(jumpFrames[i]);
+    for (int i = 0; i < NUM_STANDUP_FRAMES; i++) AssetUnloadTexture(standUpFrames[i]);
     playerFrames.clear();
     char buf[64];
 
     if (skin == 0) { // Default skin
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d.png", i); playerFrames.push_back(LoadTexture(buf)); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d.png", i); jumpFrames[i - 1] = LoadTexture(buf); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d.png", 5-i); standUpFrames[i-1] = LoadTexture(buf); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d.png", i); playerFrames.push_back(AssetLoadTexture(buf, "skin")); playerRunMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d.png", i); jumpFrames[i - 1] = AssetLoadTexture(buf, "skin"); playerJumpMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d.png", 5-i); standUpFrames[i-1] = AssetLoadTexture(buf, "skin"); }
     }
     else if (skin == 1) { // Alt 1
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d%d.png", i, i); playerFrames.push_back(LoadTexture(buf)); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d%d.png", i, i); jumpFrames[i - 1] = LoadTexture(buf); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d%d.png", 5-i, 5-i); standUpFrames[i-1] = LoadTexture(buf); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d%d.png", i, i); playerFrames.push_back(AssetLoadTexture(buf, "skin")); playerRunMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d%d.png", i, i); jumpFrames[i - 1] = AssetLoadTexture(buf, "skin"); playerJumpMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d%d.png", 5-i, 5-i); standUpFrames[i-1] = AssetLoadTexture(buf, "skin"); }
     }
     else if (skin == 2) { // Alt 2
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d%d%d.png", i,i,i); playerFrames.push_back(LoadTexture(buf)); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d%d%d.png", i,i,i); jumpFrames[i - 1] = LoadTexture(buf); }
-        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d%d%d.png", 5-i,5-i,5-i); standUpFrames[i-1] = LoadTexture(buf); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/s%d%d%d.png", i,i,i); playerFrames.push_back(AssetLoadTexture(buf, "skin")); playerRunMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/j%d%d%d.png", i,i,i); jumpFrames[i - 1] = AssetLoadTexture(buf, "skin"); playerJumpMasks[i - 1] = LoadHitMask(buf, PLAYER_SCALE); }
+        for (int i = 1; i <= 4; i++) { sprintf(buf, "img/w%d%d%d.png", 5-i,5-i,5-i); standUpFrames[i-1] = AssetLoadTexture(buf, "skin"); }
     }
 }
 
 
 void LoadAssets() {
-    clockTexture = LoadTexture("img/clock.png");
-    bgm1 = LoadMusicStream("sound/bgm1.ogg");
-    bg1 = LoadTexture("img/bg1.png");
-    bg2 = LoadTexture("img/bg2.png");
-    pauseIcon = LoadTexture("img/p.png");
-    resumeIcon = LoadTexture("img/r.png");
-    workshopIcon = LoadTexture("img/workshop.png");
-    highScoreIcon = LoadTexture("img/hs.png");
-    coinTexture = LoadTexture("img/coin.png");
-    magnetTexture = LoadTexture("img/magnet.png");
-    rockTexture = LoadTexture("img/rock.png");
-    treeTexture = LoadTexture("img/tree.png");
-    icTexture = LoadTexture("img/ic.png");
-    icDestroyedTexture = LoadTexture("img/icd.png");
-    healthTexture = LoadTexture("img/he.png");
-    manaTexture = LoadTexture("img/mi.png");
-    bankaiSnd = LoadSound("sound/bankai.ogg");
-    rainSnd = LoadSound("sound/rain.ogg");
-    thunderSnd = LoadSound("sound/th.ogg");
+    MemScope scope(MEM_TAG_ASSETS);
+    clockTexture = AssetLoadTexture("img/clock.png", "world");
+    bgm1 = AssetLoadMusic("sound/bgm1.ogg", "music", IDLE_AUDIO_BUFFER);
+    bg1 = AssetLoadTexture("img/bg1.png", "world");
+    bg2 = AssetLoadTexture("img/bg2.png", "world");
+    pauseIcon = AssetLoadTexture("img/p.png", "ui");
+    resumeIcon = AssetLoadTexture("img/r.png", "ui");
+    workshopIcon = AssetLoadTexture("img/workshop.png", "ui");
+    highScoreIcon = AssetLoadTexture("img/hs.png", "ui");
+    coinTexture = AssetLoadTexture("img/coin.png", "world");
+    magnetTexture = AssetLoadTexture("img/magnet.png", "world");
+    rockTexture = AssetLoadTexture("img/rock.png", "world");
+    treeTexture = AssetLoadTexture("img/tree.png", "world");
+    icTexture = AssetLoadTexture("img/ic.png", "world");
+    icDestroyedTexture = AssetLoadTexture("img/icd.png", "world");
+    healthTexture = AssetLoadTexture("img/he.png", "ui");
+    manaTexture = AssetLoadTexture("img/mi.png", "ui");
+    bankaiSnd = AssetLoadSound("sound/bankai.ogg", "sfx");
+    rainSnd = AssetLoadSound("sound/rain.ogg", "sfx");
+    thunderSnd = AssetLoadSound("sound/th.ogg", "sfx");
     LoadSkin(selectedSkin);
-    soundOnTexture = LoadTexture("img/sb.png");
-    soundOffTexture = LoadTexture("img/sbd.png");
-    exitIcon = LoadTexture("img/exit.png");
-    birdTexture = LoadTexture("img/bird.png");
-    skinPreviews[0] = LoadTexture("img/s1p.png");
-    skinPreviews[1] = LoadTexture("img/s11p.png");
-    skinPreviews[2] = LoadTexture("img/s111p.png");
+    soundOnTexture = AssetLoadTexture("img/sb.png", "ui");
+    soundOffTexture = AssetLoadTexture("img/sbd.png", "ui");
+    exitIcon = AssetLoadTexture("img/exit.png", "ui");
+    birdTexture = AssetLoadTexture("img/bird.png", "world");
+    skinPreviews[0] = AssetLoadTexture("img/s1p.png", "ui");
+    skinPreviews[1] = AssetLoadTexture("img/s11p.png", "ui");
+    skinPreviews[2] = AssetLoadTexture("img/s111p.png", "ui");
 }
 void UnloadAssets() {
-    for (int i = 0; i < NUM_SKINS; i++) UnloadTexture(skinPreviews[i]);
-    for (auto& t : playerFrames) UnloadTexture(t);
-    for (int i = 0; i < 4; i++) UnloadTexture(jumpFrames[i]);
-    for (int i = 0; i < NUM_STANDUP_FRAMES; i++) UnloadTexture(standUpFrames[i]);
-    UnloadTexture(bg1); UnloadTexture(bg2);
-    UnloadTexture(workshopIcon); UnloadTexture(highScoreIcon);
-    UnloadTexture(coinTexture); UnloadTexture(magnetTexture);
-    UnloadTexture(rockTexture); UnloadTexture(treeTexture);
-    UnloadTexture(icTexture); UnloadTexture(icDestroyedTexture);
-    UnloadTexture(pauseIcon); UnloadTexture(resumeIcon);
-    UnloadTexture(soundOnTexture); UnloadTexture(soundOffTexture);
-    UnloadTexture(healthTexture); UnloadTexture(manaTexture);
-    UnloadSound(bankaiSnd);
-    UnloadTexture(birdTexture);
-    UnloadSound(rainSnd);
-    UnloadSound(thunderSnd);
-    UnloadTexture(clockTexture);
-    UnloadTexture(exitIcon);
+    for (int i = 0; i < NUM_SKINS; i++) AssetUnloadTexture(skinPreviews[i]);
+    for (auto& t : playerFrames) AssetUnloadTexture(t);
+    for (int i = 0; i < 4; i++) AssetUnloadTexture(jumpFrames[i]);
+    for (int i = 0; i < NUM_STANDUP_FRAMES; i++) AssetUnloadTexture(standUpFrames[i]);
+    AssetUnloadTexture(bg1); AssetUnloadTexture(bg2);
+    AssetUnloadTexture(workshopIcon); AssetUnloadTexture(highScoreIcon);
+    AssetUnloadTexture(coinTexture); AssetUnloadTexture(magnetTexture);
+    AssetUnloadTexture(rockTexture); AssetUnloadTexture(treeTexture);
+    AssetUnloadTexture(icTexture); AssetUnloadTexture(icDestroyedTexture);
+    AssetUnloadTexture(pauseIcon); AssetUnloadTexture(resumeIcon);
+    AssetUnloadTexture(soundOnTexture); AssetUnloadTexture(soundOffTexture);
+    AssetUnloadTexture(healthTexture); AssetUnloadTexture(manaTexture);
+    AssetUnloadSound(bankaiSnd);
+    AssetUnloadTexture(birdTexture);
+    AssetUnloadSound(rainSnd);
+    AssetUnloadSound(thunderSnd);
+    AssetUnloadTexture(clockTexture);
+    AssetUnloadTexture(exitIcon);
 }
 
 // -------------- Day-Night --------------
@@ -306,35 +561,21 @@ Color phaseColors[numPhases] = {
     {0, 0, 139, 85},
     {0, 0, 220, 95}
 };
-Color LerpColor(Color color1, Color color2, float t) {
-    Color result;
-    result.r = (unsigned char)(color1.r + (color2.r - color1.r) * t);
-    result.g = (unsigned char)(color1.g + (color2.g - color1.g) * t);
-    result.b = (unsigned char)(color1.b + (color2.b - color1.b) * t);
-    result.a = (unsigned char)(color1.a + (color2.a - color1.a) * t);
-    return result;
-}
-float Distance(Vector2 a, Vector2 b) { return sqrtf((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)); }
-Vector2 Normalize(Vector2 v) {
-    float length = sqrtf(v.x * v.x + v.y * v.y);
-    if (length > 0) return { v.x / length, v.y / length };
-    return { 0, 0 };
-}
-void SpawnCoinBurst(std::vector<Particle>& burstParticles, Vector2 pos) {
-    int numParticles = 20;
-    for (int i = 0; i < numParticles; i++) {
-        float angle = 2 * PI * i / numParticles;
-        float speed = 180 + GetRandomValue(-30, 30);
-        Vector2 vel = {cosf(angle) * speed, sinf(angle) * speed - GetRandomValue(30, 90)};
-        Particle p;
-        p.position = pos;
-        p.velocity = vel;
-        p.life = 0.23f + GetRandomValue(0, 10) / 100.0f;
-        p.maxLife = p.life;
-        p.color = GOLD;
-        burstParticles.push_back(p);
+// Sky tint over the whole cycle, sampled once at startup instead of lerped every frame
+const int DAY_NIGHT_LUT_SIZE = 1024;
+Color dayNightLut[DAY_NIGHT_LUT_SIZE];
+void BuildDayNightLut() {
+    for (int i = 0; i < DAY_NIGHT_LUT_SIZE; i++) {
+        float timer = dayNightDuration * i / DAY_NIGHT_LUT_SIZE;
+        int phaseIndex = (int)(timer / phaseDuration);
+        float t = (timer - phaseIndex * phaseDuration) / phaseDuration;
+        dayNightLut[i] = LerpColor(phaseColors[phaseIndex], phaseColors[(phaseIndex + 1) % numPhases], t);
     }
 }
+Color DayNightColor(float timer) {
+    int i = (int)(std::fmod(timer, dayNightDuration) / dayNightDuration * DAY_NIGHT_LUT_SIZE);
+    return dayNightLut[i < 0 ? 0 : i % DAY_NIGHT_LUT_SIZE];
+}
 
 // -------------- UI State --------------
 unsigned char tapTextAlpha = 80;
@@ -343,26 +584,375 @@ float bg1Offset = 0, bg2Offset = 0, bgScrollSpeed = 60;
 Rectangle workshopRect = { SCREEN_WIDTH - 78, 24, (float)iconSize, (float)iconSize };
 Rectangle highScoreRect = { 30, 24, (float)iconSize, (float)iconSize };
 
+// ------------ Shop Panel --------------
+const int SHOP_NUM_BTNS = 5;
+const int SHOP_BTN_W = 480, SHOP_BTN_H = 70, SHOP_GAP_Y = 30;
+const int SHOP_START_X = SCREEN_WIDTH / 2 - SHOP_BTN_W / 2, SHOP_START_Y = 240;
+const Rectangle SHOP_PANEL_BOUNDS = { SHOP_START_X - 20, 140, SHOP_BTN_W + 200, 620 };
+Rectangle ShopButtonRect(int i) {
+    return { (float)SHOP_START_X, (float)(SHOP_START_Y + i * (SHOP_BTN_H + SHOP_GAP_Y)), (float)SHOP_BTN_W, (float)SHOP_BTN_H };
+}
+bool ShopCanBuy(int i) {
+    switch (i) {
+        case 0: return maxHealth < 200 && totalCoins >= UPGRADE_COST;
+        case 1: return maxMana < 200 && totalCoins >= UPGRADE_COST;
+        case 2: return getBankaiCooldown() > BANKAI_COOLDOWN_MIN && totalCoins >= UPGRADE_COST;
+        case 3: return getBankaiCost() > BANKAI_COST_MIN && totalCoins >= UPGRADE_COST;
+        default: return true;
+    }
+}
+void ShopClick(Vector2 mouse) {
+    int hit = -1;
+    for (int i = 0; i < SHOP_NUM_BTNS; i++)
+        if (CheckCollisionPointRec(mouse, ShopButtonRect(i))) hit = i;
+    if (hit < 0 || !ShopCanBuy(hit)) return;
+    switch (hit) {
+        case 0: maxHealth += HEALTH_MANA_STEP; if (maxHealth > 200) maxHealth = 200; break;
+        case 1: maxMana += HEALTH_MANA_STEP; if (maxMana > 200) maxMana = 200; break;
+        case 2: bankaiCooldownUpgrade++; break;
+        case 3: bankaiManaCostUpgrade++; break;
+        default:
+            selectedSkin = (selectedSkin + 1) % NUM_SKINS;
+            SaveUpgrades();
+            LoadSkin(selectedSkin);
+            return;
+    }
+    totalCoins -= UPGRADE_COST;
+    SaveUpgrades();
+    SaveStats();
+}
+int ShopHoveredButton() {
+    for (int i = 0; i < SHOP_NUM_BTNS; i++)
+        if (CheckCollisionPointRec(GetMousePosition(), ShopButtonRect(i))) return i;
+    return -1;
+}
+void DrawShopPanel(int hovered) {
+    CmdText(TextFormat("Total Coins: %d", totalCoins), SCREEN_WIDTH / 2 - 180, 150, 32, DARKGRAY);
+
+    int btnH = SHOP_BTN_H, gapY = SHOP_GAP_Y;
+    int startX = SHOP_START_X, startY = SHOP_START_Y;
+    Rectangle btns[SHOP_NUM_BTNS];
+    for (int i = 0; i < SHOP_NUM_BTNS; i++) btns[i] = ShopButtonRect(i);
+
+    Color buy = (Color){180, 130, 255, 220};
+    Color buyHover = (Color){200, 160, 255, 240};
+    Color noBuy = (Color){150,150,150,170};
+
+    for (int i = 0; i < SHOP_NUM_BTNS; i++) {
+        CmdRectangleRec(btns[i], i == hovered ? buyHover : buy);
+    }
+    // Health upgrade
+    bool maxedHealth = (maxHealth >= 200);
+    bool canBuyHealth = ShopCanBuy(0);
+    if (!canBuyHealth) CmdRectangleRec(btns[0], noBuy);
+    CmdTextureEx(healthTexture, (Vector2){(float)(startX), (float)(startY + 18)}, 0.0f, 0.05f, WHITE);
+    CmdText(TextFormat("Max Health: %d  (+10)", maxHealth), startX +60, startY + 12, 32, PINK);
+    CmdTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 18)}, 0.0f, 0.03f, WHITE);
+    CmdText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 22, 28, DARKGRAY);
+    if (maxedHealth) CmdText("MAX", startX + 415, startY + 12, 28, RED);
+
+    // Mana upgrade
+    bool maxedMana = (maxMana >= 200);
+    bool canBuyMana = ShopCanBuy(1);
+    if (!canBuyMana) CmdRectangleRec(btns[1], noBuy);
+    CmdTextureEx(manaTexture, (Vector2){(float)(startX), (float)(startY + btnH + gapY + 18)}, 0.0f, 0.11f, WHITE);
+    CmdText(TextFormat("Max Mana: %d  (+10)", maxMana), startX + 60, startY + btnH + gapY + 12, 32, BLACK);
+    CmdTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + btnH + gapY + 18)}, 0.0f, 0.03f, WHITE);
+    CmdText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + btnH + gapY + 22, 28, DARKGRAY);
+    if (maxedMana) CmdText("MAX", startX + 415, startY + btnH + gapY + 12, 28, RED);
+
+    // Bankai Cooldown (with clock icon)
+    float showCd = getBankaiCooldown();
+    bool minCd = (showCd <= BANKAI_COOLDOWN_MIN);
+    bool canBuyCd = ShopCanBuy(2);
+    if (!canBuyCd) CmdRectangleRec(btns[2], noBuy);
+    CmdTextureEx(clockTexture, (Vector2){(float)(startX), (float)(startY + 2*(btnH + gapY) + 18)}, 0.0f, 0.04f, WHITE);
+    CmdText(TextFormat("Bankai Cooldown: %.0fs(-5s)", showCd), startX + 60, startY + 2*(btnH + gapY) + 12, 32, BLACK);
+    CmdTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 2*(btnH + gapY) + 18)}, 0.0f, 0.03f, WHITE);
+    CmdText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 2*(btnH + gapY) + 22, 28, DARKGRAY);
+    if (minCd) CmdText("MIN", startX + 420, startY + 2*(btnH + gapY) + 12, 28, RED);
+
+    // Bankai Mana Cost
+    int showCost = getBankaiCost();
+    bool minCost = (showCost <= BANKAI_COST_MIN);
+    bool canBuyCost = ShopCanBuy(3);
+    if (!canBuyCost) CmdRectangleRec(btns[3], noBuy);
+    CmdTextureEx(manaTexture, (Vector2){(float)(startX), (float)(startY + 3*(btnH + gapY) + 18)}, 0.0f, 0.11f, WHITE);
+    CmdText(TextFormat("Bankai Cost: %d  (-2)", showCost), startX + 60, startY + 3*(btnH + gapY) + 12, 32, BLACK);
+    CmdTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 3*(btnH + gapY) + 18)}, 0.0f, 0.03f, WHITE);
+    CmdText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 3*(btnH + gapY) + 22, 28, DARKGRAY);
+    if (minCost) CmdText("MIN", startX + 420, startY + 3*(btnH + gapY) + 12, 28, RED);
+
+    // --- SKIN SELECTION SLOT ---
+    CmdText("Selected Skin:", startX + 60, startY + 4*(btnH+gapY) + 12, 32, DARKBLUE);
+    char skinName[32];
+    if (selectedSkin == 0) strcpy(skinName, "YUSEOL");
+    else if (selectedSkin == 1) strcpy(skinName, "ITACHI");
+    else if (selectedSkin == 2) strcpy(skinName, "GOKU");
+    else strcpy(skinName, "???");
+
+    CmdText(skinName, startX + 300, startY + 4*(btnH+gapY) + 12, 32, (Color){40, 140, 220, 255});
+    // Preview: show first player frame of selected skin
+
+    float previewScale = 0.13f; // You can adjust this
+    CmdTextureEx(skinPreviews[selectedSkin], {(float)(startX+10), (float)(startY + 4*(btnH+gapY) + 8)}, 0.0f, previewScale, WHITE);
+}
+
+// ------------ Retained UI Panels --------------
+UiCache shopCache, highScoreCache, creditsCache, hudCache;
+
+unsigned long long ShopPanelKey(int hovered) {
+    int state[] = { totalCoins, maxHealth, maxMana, bankaiCooldownUpgrade, bankaiManaCostUpgrade, selectedSkin, hovered };
+    return HashBytes(state, sizeof(state));
+}
+
+void DrawHudPanel(int coinCount, int health, int mana, float coinScale) {
+    CmdTextureEx(coinTexture, { 20, 20 }, 0.0f, coinScale, WHITE);
+    CmdText(TextFormat("%d", coinCount), 80, 25, 40, DARKPURPLE);
+    float iconOffsetY = 20 + coinTexture.height * coinScale + 12;
+    CmdTextureEx(healthTexture, { 20, iconOffsetY }, 0.0f, 0.05, WHITE);
+    CmdText(TextFormat("%d", health), 80, (int)iconOffsetY + 5, 40, RED);
+    float manaOffsetY = iconOffsetY + healthTexture.height * coinScale + 12;
+    CmdTextureEx(manaTexture, { 20, manaOffsetY }, 0.0f, 0.1, WHITE);
+    CmdText(TextFormat("%d", mana), 80, (int)manaOffsetY + 5, 40, BLUE);
+}
+
+void DrawHighScorePanel() {
+    CmdText("HIGH SCORE", SCREEN_WIDTH / 2 - 140, 150, 40, RED);
+    CmdText(TextFormat("Best Score: %d", highScore), SCREEN_WIDTH / 2 - 120, 240, 28, BLACK);
+    CmdText("Top 5 Highscores:", SCREEN_WIDTH / 2 - 140, 300, 28, WHITE);
+    for (int i = 0; i < MAX_HIGHSCORES; i++) {
+        CmdText(TextFormat("%d. %-20s %5d", i+1, highScores[i].name, highScores[i].score), SCREEN_WIDTH/2 - 120, 340 + i*38, 28, (i==0?GOLD: (i==1)?(Color){192,192,192,255}: (i==2)?(Color){205,127,50,255}:WHITE));
+    }
+}
+
+// Credits and How to Play - Multi-line Centered, recorded as if the zen page sat at x = 0
+void DrawCreditsPanel() {
+    const char* credits[] = {
+        "Credits",
+        "A.S.Ayon ",
+        "Tahsin Mubbassir",
+        "Tilde Ipson ",
+        "Nahid",
+        "",
+        "How to Play",
+        "Explore and Enjoy"
+    };
+    int numCredits = sizeof(credits)/sizeof(credits[0]);
+    int baseFont = tapFontSize + 8;
+    int subFont = tapFontSize;
+
+    int y = SCREEN_HEIGHT / 2 - (numCredits * subFont) / 2 - 30;
+
+    for (int i = 0; i < numCredits; i++) {
+        int font = (i == 0 || i == 5) ? baseFont : subFont;
+        int width = TextWidth(credits[i], font);
+        CmdText(
+            credits[i],
+            (int)(SCREEN_WIDTH / 2 - width / 2),
+            y,
+            font,
+            (Color){ 30, 30, 30, tapTextAlpha }
+        );
+        y += font + ((i == 0 || i == 5) ? 16 : 6);
+    }
+}
+
+// Redraws the cached panels whose contents changed; runs before the frame is recorded
+void RefreshUiCaches(int coinCount, int health, int mana, float coinScale) {
+    if (currentState == SHOP) {
+        int hovered = ShopHoveredButton();
+        if (UiCacheBegin(shopCache, SHOP_PANEL_BOUNDS, ShopPanelKey(hovered))) {
+            DrawShopPanel(hovered);
+            UiCacheEnd(shopCache);
+        }
+    }
+    if (currentState == HIGH_SCORE) {
+        unsigned long long key = HashBytes(highScores, sizeof(highScores), (unsigned long long)highScore);
+        if (UiCacheBegin(highScoreCache, { SCREEN_WIDTH / 2 - 160, 140, 640, 400 }, key)) {
+            DrawHighScorePanel();
+            UiCacheEnd(highScoreCache);
+        }
+    }
+    if (currentState == ZEN_TRANSITION || currentState == ZEN_MODE || currentState == ZEN_TRANSITION_BACK) {
+        if (UiCacheBegin(creditsCache, { SCREEN_WIDTH / 2 - 300, 240, 600, 360 }, tapTextAlpha)) {
+            DrawCreditsPanel();
+            UiCacheEnd(creditsCache);
+        }
+    }
+    if (currentState == GAME) {
+        int values[] = { coinCount, health, mana };
+        if (UiCacheBegin(hudCache, { 16, 16, 320, 150 }, HashBytes(values, sizeof(values)))) {
+            DrawHudPanel(coinCount, health, mana, coinScale);
+            UiCacheEnd(hudCache);
+        }
+    }
+}
+
+void UnloadUiCaches() {
+    UiCacheUnload(shopCache);
+    UiCacheUnload(highScoreCache);
+    UiCacheUnload(creditsCache);
+    UiCacheUnload(hudCache);
+}
+
 // ------------- Game State --------------
 std::vector<Coin> coins;
 std::vector<Magnet> magnets;
 std::vector<Rock> rocks;
 std::vector<Tree> trees;
 std::vector<Particle> burstParticles;
-Ic ic = { {0, 0}, false, false, 0 };
+
+// A scenario widens the pools it loads; real pickups keep their own particle room
+void ReserveEntityPools(const Scenario* sc) {
+    MemScope scope(MEM_TAG_ENTITIES);
+    coins.reserve(sc ? std::max(MAX_COINS, sc->coins) : MAX_COINS);
+    magnets.reserve(MAX_MAGNETS);
+    rocks.reserve(MAX_ROCKS);
+    trees.reserve(MAX_TREES);
+    birds.reserve(sc ? std::max(MAX_BIRDS, sc->birds) : MAX_BIRDS);
+    burstParticles.reserve(MAX_BURST_PARTICLES + (sc ? sc->particles : 0));
+    rainDrops.reserve(MAX_RAIN_DROPS);
+    snowflakes.reserve(sc ? std::max(MAX_SNOWFLAKES, sc->snowflakes) : MAX_SNOWFLAKES);
+    // Every queued sprite at once, plus the ic
+    SpriteQueueReserve((int)(coins.capacity() + magnets.capacity() + rocks.capacity() + trees.capacity() + birds.capacity()) + 1);
+}
+Ic ic = { {0, 0}, {0, 0}, false, false, 0 };
 float icSpawnTimer = 0.0f, icSpawnInterval = 10.0f;
 float icSlowTimer = 0.0f;
 bool icSlowing = false;
 
-float birdSpawnTimer = 0.0f, birdSpawnInterval = 3.0f + (float)GetRandomValue(0, 200)/50.0f; // 3–7s
+float birdSpawnTimer = 0.0f, birdSpawnInterval = 3.0f + (float)SimRandomValue(0, 200)/50.0f; // 3–7s
+
+// --------- Coin Rush ---------
+// Every RUSH_EVERY_COINS coins a rush starts (see coinrush.h): the screen fills
+// with RUSH_COINS small coins, topped up from the right until the last second,
+// all pulled to the player. RUSH_COINS_PER_COIN of them make one real coin.
+// Rush ticks are left out of the rewind history, which restarts when it ends.
+#define RUSH_EVERY_COINS 50
+#define RUSH_COINS 5000
+#define RUSH_DURATION 8.0f
+#define RUSH_TAIL 1.0f            // no top-ups in the last second, the field drains
+#define RUSH_PULL 900.0f          // px/s
+#define RUSH_PICKUP_RADIUS 60.0f
+#define RUSH_BURST_CELL 64.0f
+#define RUSH_PARTICLES (MAX_BURST_PARTICLES / 4)
+#define RUSH_COINS_PER_COIN 50
+#define RUSH_COIN_SCALE 0.6f      // of a regular coin
+float rushTimer = 0.0f;           // > 0 while a rush is on
+int rushTarget = RUSH_COINS, nextRushAt = RUSH_EVERY_COINS, rushBank = 0;
+
+void StartCoinRush(int coins, float playerX) {
+    CoinRushClear();
+    CoinRushFill(coins, { playerX + 200.0f, 60.0f, SCREEN_WIDTH + 200.0f - playerX, GROUND_Y - 100.0f });
+    rushTarget = coins;
+    rushTimer = RUSH_DURATION;
+}
+
+void EndCoinRush(int coinCount) {
+    CoinRushClear();
+    rushTimer = 0.0f;
+    nextRushAt = coinCount + RUSH_EVERY_COINS;
+    RewindReset();
+}
+
+// ------------- Fixed Tick --------------
+// The simulation steps at SIM_HZ however fast frames are presented (all motion
+// constants are per tick); drawing interpolates between the last two ticks.
+#define SIM_HZ 60
+const float SIM_DT = 1.0f / SIM_HZ;
+const float MAX_FRAME_DT = 0.25f; // longer stalls are dropped rather than caught up
+float simAccumulator = 0.0f;
+float renderAlpha = 1.0f;         // 0 = previous tick, 1 = current tick
+
+#define TICK_MAX_CHARS 8
+struct TickInput {
+    bool click, jump, bankai, left, right, back, rewind;
+    bool erase, enter, anyKey, toggleStats, toggleAssets, toggleSharpen;
+    int charCount;
+    int chars[TICK_MAX_CHARS];
+    Vector2 mouse;
+};
 
-std::random_device rd;
-std::mt19937 gen(rd());
-std::uniform_real_distribution<> disXCoin(0.0f, SCREEN_WIDTH * 10.0f);
-std::uniform_real_distribution<> disYCoin(500.0f, 600.0f);
-std::uniform_real_distribution<> disRockInterval(ROCK_SPAWN_MIN_INTERVAL, ROCK_SPAWN_MAX_INTERVAL);
-std::uniform_real_distribution<> disTreeInterval(TREE_SPAWN_MIN_INTERVAL, TREE_SPAWN_MAX_INTERVAL);
-std::uniform_real_distribution<> disIcInterval(8.0f, 14.0f);
+// Takes this tick's presses off the input queue in arrival order. A press the
+// tick already holds (a second click, a second jump) stays queued for the next
+// tick, so none are lost on frames that run no tick or merged on frames that run several.
+TickInput ConsumeInput() {
+    TickInput in = {};
+    InputEvent e;
+    while (InputPeek(e)) {
+        bool* flag = nullptr;
+        if (e.type == INPUT_CLICK) flag = &in.click;
+        else if (e.type == INPUT_CHAR) { if (in.charCount == TICK_MAX_CHARS) break; }
+        else switch (e.value) {
+            case KEY_SPACE: flag = &in.jump; break;
+            case KEY_B: flag = &in.bankai; break;
+            case KEY_LEFT: flag = &in.left; break;
+            case KEY_RIGHT: flag = &in.right; break;
+            case KEY_ESCAPE: flag = &in.back; break;
+            case KEY_BACKSPACE: flag = &in.erase; break;
+            case KEY_ENTER: flag = &in.enter; break;
+            case KEY_F3: flag = &in.toggleStats; break;
+            case KEY_F4: flag = &in.toggleAssets; break;
+            case KEY_F6: flag = &in.toggleSharpen; break;
+            default: break;
+        }
+        if (flag && *flag) break;
+        if (flag) *flag = true;
+        if (e.type == INPUT_CLICK) in.mouse = e.mouse;
+        if (e.type == INPUT_CHAR) in.chars[in.charCount++] = e.value;
+        if (e.type == INPUT_KEY) in.anyKey = true;
+        InputConsumed(e);
+        InputPop();
+    }
+    in.back |= in.erase;
+    if (!in.click) in.mouse = GetMousePosition();
+    in.rewind = IsKeyDown(KEY_R); // held, not pressed
+    return in;
+}
+
+Vector2 LerpPos(Vector2 prev, Vector2 cur) {
+    return { prev.x + (cur.x - prev.x) * renderAlpha, prev.y + (cur.y - prev.y) * renderAlpha };
+}
+
+// Scroll offsets wrap at `period`; interpolate forward across the wrap
+float LerpWrapped(float prev, float cur, float period) {
+    float d = cur - prev;
+    if (d < 0.0f) d += period;
+    return prev + d * renderAlpha;
+}
+
+// Translucent ghosts of recorded runs, grouped by frame so each texture is bound once
+GhostDraw ghostDraws[MAX_GHOSTS];
+void DrawGhosts(float playerScale) {
+    const Color tint = { 255, 255, 255, 90 };
+    int count = GhostsCollect(ghostDraws, MAX_GHOSTS);
+    for (int i = 0; i < count; i++) {
+        const GhostDraw& g = ghostDraws[i];
+        Texture2D tex = g.frame < 4 ? playerFrames[g.frame] : jumpFrames[g.frame - 4];
+        Vector2 pos = LerpPos({ PLAYER_X + g.prevOffset, g.prevY }, { PLAYER_X + g.offset, g.y });
+        if (pos.x > SCREEN_WIDTH || pos.x + tex.width * playerScale < 0) continue;
+        CmdTextureEx(tex, pos, 0.0f, playerScale, tint);
+    }
+}
+
+float prevBg1Offset = 0.0f, prevBg2Offset = 0.0f;
+
+// Remembers where everything was before the tick moves it
+void SnapshotSimState() {
+    for (auto& c : coins) c.prevPosition = c.position;
+    for (auto& m : magnets) m.prevPosition = m.position;
+    for (auto& r : rocks) r.prevPosition = r.position;
+    for (auto& t : trees) t.prevPosition = t.position;
+    for (auto& b : birds) b.prevPosition = b.position;
+    for (auto& p : burstParticles) p.prevPosition = p.position;
+    for (auto& f : snowflakes) { f.prevX = f.x; f.prevY = f.y; }
+    for (auto& d : rainDrops) { d.prevX = d.x; d.prevY = d.y; }
+    ic.prevPosition = ic.position;
+    CoinRushSnapshot();
+    prevBg1Offset = bg1Offset;
+    prevBg2Offset = bg2Offset;
+}
 
 void InitGameLogic(
     Vector2& playerPos, float& verticalSpeed, float& currentSpeed, float& speedTimer,
@@ -377,21 +967,25 @@ void InitGameLogic(
     verticalSpeed = 0.0f; currentSpeed = PLAYER_SPEED; speedTimer = 0.0f;
     onGround = true; currentFrame = 0; frameCounter = 0.0f; coinCount = 0;
     magnetActive = false; magnetTimer = 0.0f; magnetSpawnTimer = 0.0f;
-    rockSpawnTimer = 0.0f; rockSpawnInterval = (float)disRockInterval(gen);
-    treeSpawnTimer = 0.0f; treeSpawnInterval = (float)disTreeInterval(gen);
+    rockSpawnTimer = 0.0f; rockSpawnInterval = SimRandomFloat(ROCK_SPAWN_MIN_INTERVAL, ROCK_SPAWN_MAX_INTERVAL);
+    treeSpawnTimer = 0.0f; treeSpawnInterval = SimRandomFloat(TREE_SPAWN_MIN_INTERVAL, TREE_SPAWN_MAX_INTERVAL);
     gameOver = false;
     rocks.clear(); magnets.clear(); trees.clear(); burstParticles.clear();
     for (auto& c : coins) c.active = true;
-    ic = { {0, 0}, false, false, 0 };
+    ic = { {0, 0}, {0, 0}, false, false, 0 };
     icSpawnTimer = 0.0f;
-    icSpawnInterval = (float)disIcInterval(gen);
+    icSpawnInterval = SimRandomFloat(8.0f, 14.0f);
     icSlowTimer = 0.0f;
     icSlowing = false;
     health = maxHealth;
     mana = maxMana;
 
     birds.clear(); birdSpawnTimer = 0.0f;
-    birdSpawnInterval = 3.0f + (float)GetRandomValue(0, 200)/50.0f;
+    birdSpawnInterval = 3.0f + (float)SimRandomValue(0, 200)/50.0f;
+    CoinRushClear();
+    rushTimer = 0.0f;
+    nextRushAt = RUSH_EVERY_COINS;
+    rushBank = 0;
 
     rainDrops.clear();
     raining = false;
@@ -403,34 +997,430 @@ void InitGameLogic(
     rainSoundPlaying = false;
 
     spawnBlockTimer = 0.0f; // Used for 5 second no-spawn
+    RewindReset();
+    TelemetryBeginRun();
+    GhostRecordBegin();
+    GhostsBeginRace();
 }
 
 float gameIntroTimer = 0.0f;
 const float GAME_INTRO_DURATION = 2.0f;
 bool gameIntroActive = false;
 
+// --------- Run Snapshot ---------
+// Leaving a run through the exit dialog or by closing the window suspends it to
+// RUN_SNAPSHOT_FILE; the next "tap to start" resumes it (paused) and deletes the
+// file. Bump RUN_SNAPSHOT_VERSION whenever TransferRunState changes.
+#define RUN_SNAPSHOT_FILE "suspended.run"
+#define RUN_SNAPSHOT_VERSION 2
+SnapStream runSnapshot;
+bool runSuspended = false; // a snapshot is waiting to be resumed
+
+uint32_t RunSnapshotLayout() {
+    const uint32_t sizes[] = { sizeof(Coin), sizeof(Magnet), sizeof(Rock), sizeof(Tree), sizeof(Particle),
+        sizeof(Ic), sizeof(SnowFlake), sizeof(RainDrop), sizeof(Bird), sizeof(Vector2), sizeof(bool), sizeof(int) };
+    uint32_t h = 0;
+    for (uint32_t v : sizes) h = h * 31 + v;
+    return h;
+}
+
+// Moves the whole run through the stream, one direction or the other
+void TransferRunState(SnapStream& s,
+    Vector2& playerPos, float& verticalSpeed, float& currentSpeed, float& speedTimer,
+    bool& onGround, int& currentFrame, float& frameCounter, int& coinCount,
+    bool& magnetActive, float& magnetTimer, float& magnetSpawnTimer, float& rockSpawnTimer,
+    float& rockSpawnInterval, float& treeSpawnTimer, float& treeSpawnInterval,
+    int& health, int& mana, float& spawnBlockTimer, bool& bankaiActive, float& bankaiCooldown
+) {
+    SnapValue(s, simRngState);
+    // player
+    SnapValue(s, playerPos); SnapValue(s, verticalSpeed); SnapValue(s, onGround);
+    SnapValue(s, currentFrame); SnapValue(s, frameCounter);
+    SnapValue(s, currentSpeed); SnapValue(s, speedTimer);
+    SnapValue(s, coinCount); SnapValue(s, health); SnapValue(s, mana); SnapValue(s, manaRegenAccumulator);
+    // timers
+    SnapValue(s, magnetActive); SnapValue(s, magnetTimer); SnapValue(s, magnetSpawnTimer);
+    SnapValue(s, rockSpawnTimer); SnapValue(s, rockSpawnInterval);
+    SnapValue(s, treeSpawnTimer); SnapValue(s, treeSpawnInterval);
+    SnapValue(s, spawnBlockTimer); SnapValue(s, gameIntroTimer); SnapValue(s, gameIntroActive);
+    SnapValue(s, dayNightTimer); SnapValue(s, bg1Offset); SnapValue(s, bg2Offset);
+    SnapValue(s, bankaiActive); SnapValue(s, bankaiCooldown);
+    SnapValue(s, bankaiFlashTimer); SnapValue(s, bankaiTextAlpha);
+    // entities
+    SnapPool(s, coins); SnapPool(s, magnets); SnapPool(s, rocks); SnapPool(s, trees);
+    SnapPool(s, burstParticles); SnapPool(s, birds);
+    SnapValue(s, birdSpawnTimer); SnapValue(s, birdSpawnInterval);
+    SnapValue(s, ic); SnapValue(s, icSpawnTimer); SnapValue(s, icSpawnInterval);
+    SnapValue(s, icSlowTimer); SnapValue(s, icSlowing);
+    SnapValue(s, nextRushAt); SnapValue(s, rushBank); // a rush under way is not kept; it starts over on resume
+    // weather
+    SnapPool(s, snowflakes); SnapPool(s, rainDrops);
+    SnapValue(s, raining); SnapValue(s, rainTimer); SnapValue(s, rainState); SnapValue(s, rainPeriodCount);
+    SnapValue(s, rainNextEventTime); SnapValue(s, rainIntensity);
+    SnapValue(s, thunderTimer); SnapValue(s, thunderInterval); SnapValue(s, timeSinceGameStarted);
+}
+
+// Writes the run TransferRunState put into runSnapshot; false leaves the run to end as before
+bool WriteRunSnapshot(double startTime) {
+    runSuspended = SnapWriteFile(runSnapshot, RUN_SNAPSHOT_FILE, RUN_SNAPSHOT_VERSION, RunSnapshotLayout());
+    if (runSuspended) TraceLog(LOG_INFO, "SNAPSHOT: run suspended (%d bytes, %.2f ms)", (int)runSnapshot.bytes.size(), (GetTime() - startTime) * 1000.0);
+    else TraceLog(LOG_WARNING, "SNAPSHOT: cannot write %s", RUN_SNAPSHOT_FILE);
+    return runSuspended;
+}
+
+// --------- Rewind ---------
+// Assist mode: holding R in a run steps it back up to REWIND_SECONDS, one tick
+// per tick (see rewind.h). The kept state is plain data with fixed-size entity
+// arrays, so consecutive ticks differ in few bytes. Weather and burst particles
+// are cosmetic and are left out.
+struct WorldState {
+    uint64_t rng;
+    Vector2 playerPos;
+    float verticalSpeed, frameCounter, currentSpeed, speedTimer, manaRegen;
+    int currentFrame, coinCount, health, mana;
+    bool onGround, magnetActive, gameIntroActive, icSlowing, raining;
+    float magnetTimer, magnetSpawnTimer, rockSpawnTimer, rockSpawnInterval, treeSpawnTimer, treeSpawnInterval;
+    float spawnBlockTimer, gameIntroTimer, dayNightTimer, bg1Offset, bg2Offset, bankaiCooldown;
+    float birdSpawnTimer, birdSpawnInterval, icSpawnTimer, icSpawnInterval, icSlowTimer;
+    int rainState, rainPeriodCount;
+    float rainTimer, rainNextEventTime, rainIntensity, thunderTimer, thunderInterval, timeSinceGameStarted;
+    Ic ic;
+    uint8_t coinCountKept, magnetCount, rockCount, treeCount, birdCount;
+    Coin coins[MAX_COINS];
+    Magnet magnets[MAX_MAGNETS];
+    Rock rocks[MAX_ROCKS];
+    Tree trees[MAX_TREES];
+    Bird birds[MAX_BIRDS];
+};
+WorldState rewindState; // zero-initialized, so padding never differs between ticks
+bool rewinding = false;
+
+template <typename T>
+void SyncField(bool restore, T& live, T& kept) { if (restore) live = kept; else kept = live; }
+
+template <typename T, int N>
+void SyncPool(bool restore, std::vector<T>& pool, T (&kept)[N], uint8_t& keptCount) {
+    if (restore) { pool.assign(kept, kept + keptCount); return; } // within the reserved capacity
+    keptCount = (uint8_t)std::min((int)pool.size(), N);
+    memcpy(kept, pool.data(), keptCount * sizeof(T));
+    memset(kept + keptCount, 0, (N - keptCount) * sizeof(T)); // unused slots stay zero and XOR away
+}
+
+// Copies the run into w, or back out of it when restoring
+void SyncWorldState(WorldState& w, bool restore,
+    Vector2& playerPos, float& verticalSpeed, float& currentSpeed, float& speedTimer,
+    bool& onGround, int& currentFrame, float& frameCounter, int& coinCount,
+    bool& magnetActive, float& magnetTimer, float& magnetSpawnTimer, float& rockSpawnTimer,
+    float& rockSpawnInterval, float& treeSpawnTimer, float& treeSpawnInterval,
+    int& health, int& mana, float& spawnBlockTimer, float& bankaiCooldown
+) {
+    SyncField(restore, simRngState, w.rng);
+    SyncField(restore, playerPos, w.playerPos); SyncField(restore, verticalSpeed, w.verticalSpeed);
+    SyncField(restore, onGround, w.onGround); SyncField(restore, currentFrame, w.currentFrame);
+    SyncField(restore, frameCounter, w.frameCounter); SyncField(restore, currentSpeed, w.currentSpeed);
+    SyncField(restore, speedTimer, w.speedTimer); SyncField(restore, coinCount, w.coinCount);
+    SyncField(restore, health, w.health); SyncField(restore, mana, w.mana);
+    SyncField(restore, manaRegenAccumulator, w.manaRegen);
+    SyncField(restore, magnetActive, w.magnetActive); SyncField(restore, magnetTimer, w.magnetTimer);
+    SyncField(restore, magnetSpawnTimer, w.magnetSpawnTimer);
+    SyncField(restore, rockSpawnTimer, w.rockSpawnTimer); SyncField(restore, rockSpawnInterval, w.rockSpawnInterval);
+    SyncField(restore, treeSpawnTimer, w.treeSpawnTimer); SyncField(restore, treeSpawnInterval, w.treeSpawnInterval);
+    SyncField(restore, spawnBlockTimer, w.spawnBlockTimer);
+    SyncField(restore, gameIntroTimer, w.gameIntroTimer); SyncField(restore, gameIntroActive, w.gameIntroActive);
+    SyncField(restore, dayNightTimer, w.dayNightTimer);
+    SyncField(restore, bg1Offset, w.bg1Offset); SyncField(restore, bg2Offset, w.bg2Offset);
+    SyncField(restore, bankaiCooldown, w.bankaiCooldown);
+    SyncField(restore, birdSpawnTimer, w.birdSpawnTimer); SyncField(restore, birdSpawnInterval, w.birdSpawnInterval);
+    SyncField(restore, ic, w.ic);
+    SyncField(restore, icSpawnTimer, w.icSpawnTimer); SyncField(restore, icSpawnInterval, w.icSpawnInterval);
+    SyncField(restore, icSlowTimer, w.icSlowTimer); SyncField(restore, icSlowing, w.icSlowing);
+    SyncField(restore, raining, w.raining); SyncField(restore, rainTimer, w.rainTimer);
+    SyncField(restore, rainState, w.rainState); SyncField(restore, rainPeriodCount, w.rainPeriodCount);
+    SyncField(restore, rainNextEventTime, w.rainNextEventTime); SyncField(restore, rainIntensity, w.rainIntensity);
+    SyncField(restore, thunderTimer, w.thunderTimer); SyncField(restore, thunderInterval, w.thunderInterval);
+    SyncField(restore, timeSinceGameStarted, w.timeSinceGameStarted);
+    SyncPool(restore, coins, w.coins, w.coinCountKept);
+    SyncPool(restore, magnets, w.magnets, w.magnetCount);
+    SyncPool(restore, rocks, w.rocks, w.rockCount);
+    SyncPool(restore, trees, w.trees, w.treeCount);
+    SyncPool(restore, birds, w.birds, w.birdCount);
+}
+
+// --------- Scenario Load ---------
+// Tops the active scenario's load back up every GAME tick: coins that scrolled
+// off wrap around live again, and birds, particles and rain are refilled.
+const Scenario* scenario = nullptr;
+
+void ApplyScenarioLoad(bool& magnetActive, float& magnetTimer, float coinScale, float playerHeight) {
+    const Scenario& sc = *scenario;
+    if (sc.magnetAlways) { magnetActive = true; magnetTimer = MAGNET_DURATION; }
+    if (sc.coins > 0) {
+        for (auto& c : coins) {
+            if (c.position.x >= -coinTexture.width * coinScale) continue;
+            c.position.x += SCREEN_WIDTH * 10.0f;
+            c.position.y = SimRandomFloat(500.0f, 600.0f);
+            c.prevPosition = c.position;
+            c.active = true;
+        }
+    }
+    if (sc.birds > 0) {
+        birds.erase(std::remove_if(birds.begin(), birds.end(), [](const Bird& b) { return !b.active; }), birds.end());
+        float playerBaseY = GROUND_Y - playerHeight;
+        while ((int)birds.size() < sc.birds && PoolHasRoom(birds)) {
+            float x = SCREEN_WIDTH + (float)SimRandomValue(0, SCREEN_WIDTH * 3);
+            float y = (float)SimRandomValue(40, (int)playerBaseY - 160);
+            float speed = PLAYER_SPEED * sc.speedScale + 5.0f + SimRandomValue(0, 50) / 10.0f;
+            birds.push_back({ {x, y}, speed, BIRD_SCALE, true, {x, y} });
+        }
+    }
+    while ((int)burstParticles.size() < sc.particles && PoolHasRoom(burstParticles))
+        SpawnCoinBurst(burstParticles, { (float)SimRandomValue(0, SCREEN_WIDTH), (float)SimRandomValue(0, SCREEN_HEIGHT) });
+    if (sc.rushCoins > 0) {
+        if (rushTimer <= 0.0f) StartCoinRush(sc.rushCoins, PLAYER_X);
+        rushTimer = RUSH_DURATION;
+    }
+    if (sc.rainAlways && !raining) {
+        rainPeriodCount = 0;
+        StartRain(1.0f);
+    }
+}
+
+// --------- Export Autopilot ---------
+// Jumps the rock coming up next, so an exported clip plays like a run
+bool AutopilotWantsJump(Vector2 playerPos, float playerWidth, float speed, bool onGround) {
+    if (!onGround) return false;
+    for (const auto& r : rocks) {
+        if (!r.active) continue;
+        float gap = r.position.x - (playerPos.x + playerWidth);
+        if (gap > 0.0f && gap < speed * 12.0f) return true;
+    }
+    return false;
+}
+
+// --------- Live Metrics ---------
+// Hands the metrics server a copy of this frame's counters (see metrics.h)
+void PublishMetrics(float currentSpeed) {
+    MetricsSnapshot m;
+    memset(&m, 0, sizeof(m));
+    m.frames = (uint64_t)framesEnded;
+    m.coins = (int)coins.size();
+    m.magnets = (int)magnets.size();
+    m.rocks = (int)rocks.size();
+    m.trees = (int)trees.size();
+    m.birds = (int)birds.size();
+    m.particles = (int)burstParticles.size();
+    m.rainDrops = raining ? (int)rainDrops.size() : 0;
+    m.snowflakes = (int)snowflakes.size();
+    m.appState = currentState;
+    strncpy(m.appStateName, appStateNames[currentState], sizeof(m.appStateName) - 1);
+    m.currentSpeed = currentSpeed;
+    m.frameAllocs = lastFrameAllocs.allocs;
+    m.frameAllocBytes = lastFrameAllocs.bytes;
+    m.audioUnderruns = (uint64_t)audioUnderruns;
+    m.quality = QualityGetLevel();
+    m.resScale = ResScaleGetScale();
+    MetricsPublish(m);
+}
+
+// --------- Swept Collision Check ---------
+// Pits the swept player-vs-obstacle tests against a reference that cuts the tick
+// into 1-pixel steps, for the real sprites at scroll speeds far past normal play.
+// Fails if the swept test misses a hit or reports it later than one mask cell.
+bool RunSweptCheck(float playerWidth, float playerHeight, float rockScale) {
+    const float speeds[] = { 8.0f, 32.0f, 128.0f, 512.0f, 2048.0f };
+    const int CASES_PER_SPEED = 4000;
+    Rectangle rockSize = { 0, 0, rockTexture.width * rockScale, rockTexture.height * rockScale };
+    Rectangle birdSize = { 0, 0, birdTexture.width * BIRD_SCALE, birdTexture.height * BIRD_SCALE };
+    SetRandomSeed(35);
+    bool ok = true;
+    printf("%-8s %8s %8s %8s %8s %12s\n", "speed", "cases", "hits", "missed", "late", "tick misses");
+    for (float speed : speeds) {
+        int hits = 0, missed = 0, late = 0, discreteMisses = 0;
+        for (int n = 0; n < CASES_PER_SPEED; n++) {
+            bool bird = GetRandomValue(0, 1) == 1;
+            int frame = GetRandomValue(0, 3);
+            bool jumping = GetRandomValue(0, 1) == 1;
+            const HitMask& playerMask = jumping ? playerJumpMasks[frame] : playerRunMasks[frame];
+            const HitMask& obstacleMask = bird ? birdMask : rockMask;
+            Rectangle size = bird ? birdSize : rockSize;
+
+            Rectangle player = { PLAYER_X, GROUND_Y - playerHeight - (jumping ? GetRandomValue(0, 250) : 0), playerWidth, playerHeight };
+            Vector2 playerDelta = { 0.0f, jumping ? (float)GetRandomValue(-20, 20) : 0.0f };
+            float obstacleSpeed = bird ? speed + GetRandomValue(5, 10) : speed;
+            Rectangle obstacle = size;
+            obstacle.x = PLAYER_X + GetRandomValue(-(int)size.width, (int)(obstacleSpeed + playerWidth));
+            obstacle.y = bird ? GROUND_Y - playerHeight - GetRandomValue(160, 180) : GROUND_Y - 110;
+            Vector2 obstacleDelta = { -obstacleSpeed, 0.0f };
+
+            float toi = 0.0f;
+            bool swept = SweptMaskHit(playerMask, player, playerDelta, obstacleMask, obstacle, obstacleDelta, &toi);
+
+            int steps = (int)ceilf(fmaxf(obstacleSpeed, fabsf(playerDelta.y)));
+            float firstHit = -1.0f;
+            for (int k = 0; k <= steps && firstHit < 0.0f; k++) {
+                float t = (float)k / steps;
+                Rectangle p = { player.x, player.y + playerDelta.y * t, player.width, player.height };
+                Rectangle o = { obstacle.x + obstacleDelta.x * t, obstacle.y, obstacle.width, obstacle.height };
+                if (CheckCollisionRecs(p, o) && HitMasksOverlap(playerMask, { p.x, p.y }, obstacleMask, { o.x, o.y })) firstHit = t;
+            }
+            Rectangle pEnd = { player.x, player.y + playerDelta.y, player.width, player.height };
+            Rectangle oEnd = { obstacle.x + obstacleDelta.x, obstacle.y, obstacle.width, obstacle.height };
+            bool discrete = CheckCollisionRecs(pEnd, oEnd) && HitMasksOverlap(playerMask, { pEnd.x, pEnd.y }, obstacleMask, { oEnd.x, oEnd.y });
+
+            if (firstHit < 0.0f) continue;
+            hits++;
+            if (!discrete) discreteMisses++;
+            if (!swept) missed++;
+            else if ((toi - firstHit) * obstacleSpeed > HITMASK_CELL) late++;
+        }
+        printf("%-8.0f %8d %8d %8d %8d %12d\n", speed, CASES_PER_SPEED, hits, missed, late, discreteMisses);
+        if (missed > 0 || late > 0) ok = false;
+    }
+    printf("check swept: %s\n", ok ? "passed" : "FAILED");
+    return ok;
+}
+
 // ======= MAIN LOOP ==========
-int main() {
+int main(int argc, char** argv) {
+    // --null-render: record and count draws without submitting them (CI, no GPU work)
+    // --frames N:    quit after N frames and print the per-state draw report
+    // --res-scale S: pin the world resolution scale (0.5 - 1.5) instead of following frame time
+    // --supersample: let the world resolution grow past native on fast machines
+    // --sharpen:     sharpen the upscaled world (also F6)
+    // --quality N:   pin cosmetic quality (0 minimal - 3 high) instead of following frame time
+    // --fps N:       cap frames with a timer instead of vsync (0 = uncapped)
+    // --no-idle:     keep redrawing at full rate on static screens
+    // --check allocs: headless ten-minute simulated GAME run (restarting on game over);
+    //                fails if anything is heap-allocated after the warm-up
+    // --check swept: swept collision against a fine-stepped reference at extreme speeds
+    // --scenario NAME: play under a stress preset and print per-phase frame times;
+    //                with --null-render it runs a simulated minute flat out
+    // --metrics PORT: serve live counters for Prometheus on http://127.0.0.1:PORT/metrics
+    // --export PATH: render a run offscreen, flat out, to PATH (.y4m stream, else a PNG directory);
+    //                --frames sets its length (default one minute), an autopilot plays it
+    // --seed N:      seed the simulation (the same seed and length replay the same run)
+    bool nullRender = false, supersample = false, sharpen = false;
+    int maxFrames = 0;
+    float pinnedResScale = 0.0f;
+    int pinnedQuality = -1;
+    int fpsCap = -1; // -1 = vsync at the display rate
+    int metricsPort = 0;
+    const char* exportPath = nullptr;
+    long long seed = -1;
+    bool checkAllocs = false, checkSwept = false;
+    bool assetDump = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--null-render") == 0) nullRender = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) maxFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--res-scale") == 0 && i + 1 < argc) pinnedResScale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--supersample") == 0) supersample = true;
+        else if (strcmp(argv[i], "--sharpen") == 0) sharpen = true;
+        else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) pinnedQuality = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fpsCap = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-idle") == 0) idleThrottle = false;
+        else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) metricsPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) exportPath = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--budget-gpu") == 0 && i + 1 < argc) AssetSetBudget(ASSET_POOL_GPU, atoll(argv[++i]) << 20);
+        else if (strcmp(argv[i], "--budget-audio") == 0 && i + 1 < argc) AssetSetBudget(ASSET_POOL_AUDIO, atoll(argv[++i]) << 20);
+        else if (strcmp(argv[i], "--asset-dump") == 0) assetDump = true;
+        else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            scenario = FindScenario(argv[++i]);
+            if (!scenario) {
+                printf("unknown scenario '%s'\n", argv[i]);
+                PrintScenarios();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+            i++;
+            checkAllocs = strcmp(argv[i], "allocs") == 0;
+            checkSwept = strcmp(argv[i], "swept") == 0;
+            if (!checkAllocs && !checkSwept) {
+                printf("unknown check '%s', valid checks: allocs swept\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+    if (checkSwept) nullRender = true;
+    if (checkAllocs) {
+        nullRender = true;
+        fpsCap = 0;              // frames run back to back on a simulated clock
+        savesEnabled = false;
+        if (maxFrames == 0) maxFrames = ALLOC_WARMUP_FRAMES + 10 * 60 * SIM_HZ;
+    }
+    // Runs that restart into GAME on their own and never die
+    bool autoRun = checkAllocs || scenario || exportPath;
+    bool simulatedClock = checkAllocs || (scenario && nullRender) || exportPath;
+    if (exportPath) {
+        // Real drawing into a hidden window, as fast as it goes, at a fixed tick
+        nullRender = false;
+        savesEnabled = false;
+        fpsCap = 0;
+        idleThrottle = false;
+        if (pinnedQuality < 0) pinnedQuality = QUALITY_HIGH;
+        if (pinnedResScale <= 0.0f) pinnedResScale = 1.0f;
+        if (maxFrames == 0) maxFrames = 60 * SIM_HZ;
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        if (!ExportBegin(exportPath, SIM_HZ, 0)) {
+            printf("cannot write %s\n", exportPath);
+            return 1;
+        }
+    }
+    if (scenario) {
+        savesEnabled = false;
+        if (pinnedQuality < 0) pinnedQuality = QUALITY_HIGH; // measure the full load
+        if (nullRender) {
+            fpsCap = 0;
+            if (maxFrames == 0) maxFrames = ALLOC_WARMUP_FRAMES + 60 * SIM_HZ;
+        }
+    }
+    if (nullRender) {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        SetRenderBackend(RENDER_BACKEND_NULL);
+        if (fpsCap < 0) fpsCap = SIM_HZ; // no display to sync to
+        idleThrottle = false;            // a hidden window gets no events to wake on
+    }
+    if (fpsCap < 0) SetConfigFlags(FLAG_VSYNC_HINT);
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Snow Glide");
     SetExitKey(0);
-    SetTargetFPS(60);
+    PacerSetDisplayRate(GetMonitorRefreshRate(GetCurrentMonitor()));
+    PacerSetTargetFps(fpsCap > 0 ? fpsCap : 0);
+    if (!nullRender) {
+        ResScaleInit(SCREEN_WIDTH, SCREEN_HEIGHT, 0.5f, (supersample || pinnedResScale > 1.0f) ? 1.5f : 1.0f);
+        ResScalePin(pinnedResScale);
+        ResScaleSetSharpen(sharpen);
+        TextSdfInit();
+    }
+    QualityInit(QUALITY_HIGH);
+    QualityPin(pinnedQuality);
     InitAudioDevice();
+    SetAudioStreamBufferSizeDefault(IDLE_AUDIO_BUFFER);
     LoadUpgrades();
     LoadAssets();
     LoadStats();
     LoadSoundState();
     LoadHighScores();
+    SimSeed(seed >= 0 ? (uint64_t)seed : simulatedClock ? 1 : (uint64_t)time(nullptr)); // check, scenario and export runs replay the same run
+    runSuspended = savesEnabled && FileExists(RUN_SNAPSHOT_FILE);
+    BuildDayNightLut();
+    ReserveEntityPools(scenario);
+    FrameArenaInit(64 * 1024);
+    if (simulatedClock) isSoundOn = false;
 
     // --- Initialize SnowFlakes ---
     snowflakes.clear();
-    for (int i = 0; i < MAX_SNOWFLAKES; i++) {
+    int flakeTotal = (scenario && scenario->snowflakes > 0) ? scenario->snowflakes : MAX_SNOWFLAKES;
+    for (int i = 0; i < flakeTotal; i++) {
         SnowFlake s;
-        s.x = GetRandomValue(0, SCREEN_WIDTH);
-        s.y = GetRandomValue(0, SCREEN_HEIGHT);
-        s.speedY = 70 + GetRandomValue(0, 100);      // Faster fall
-        s.driftX = GetRandomValue(-18, 18) / 10.0f;  // More visible horizontal drift
-        s.size = 2.5f + GetRandomValue(0, 6) / 2.0f; // Slightly bigger average
-        s.opacity = 0.5f + GetRandomValue(50, 100)/255.0f; // More visible
+        s.x = SimRandomValue(0, SCREEN_WIDTH);
+        s.y = SimRandomValue(0, SCREEN_HEIGHT);
+        s.prevX = s.x; s.prevY = s.y;
+        s.speedY = 70 + SimRandomValue(0, 100);      // Faster fall
+        s.driftX = SimRandomValue(-18, 18) / 10.0f;  // More visible horizontal drift
+        s.size = 2.5f + SimRandomValue(0, 6) / 2.0f; // Slightly bigger average
+        s.opacity = 0.5f + SimRandomValue(50, 100)/255.0f; // More visible
         snowflakes.push_back(s);
     }
 
@@ -441,37 +1431,67 @@ int main() {
     soundRect = {workshopRect.x, workshopRect.y + iconSize + 40, (float)iconSize, (float)iconSize };
     exitRect = { 24, SCREEN_HEIGHT - iconSize - 32, (float)iconSize, (float)iconSize };
 
-    float playerScale = 0.4f;
+    float playerScale = PLAYER_SCALE;
     float playerHeight = playerFrames[0].height * playerScale;
     float playerWidth = playerFrames[0].width * playerScale;
     coins.clear();
     const int maxCoins = 10;
-    for (int i = 0; i < maxCoins;) {
-        float x = (float)disXCoin(gen);
-        float y = (float)disYCoin(gen);
+    // Scenario coin sets skip the spacing check, it is quadratic in the set size
+    for (int i = 0; scenario && i < scenario->coins; i++) {
+        float x = SimRandomFloat(0.0f, SCREEN_WIDTH * 10.0f);
+        float y = SimRandomFloat(500.0f, 600.0f);
+        coins.push_back({ { x, y }, true, { x, y } });
+    }
+    for (int i = (int)coins.size(); i < maxCoins;) {
+        float x = SimRandomFloat(0.0f, SCREEN_WIDTH * 10.0f);
+        float y = SimRandomFloat(500.0f, 600.0f);
         bool tooClose = false;
         for (const auto& existing : coins) {
             float dx = fabsf(x - existing.position.x);
             float dy = fabsf(y - existing.position.y);
             if (dx < 32.0f && dy < 40.0f) { tooClose = true; break; }
         }
-        if (!tooClose) { coins.push_back({ { x, y }, true }); i++; }
+        if (!tooClose) { coins.push_back({ { x, y }, true, { x, y } }); i++; }
     }
 
     Vector2 playerPos = { PLAYER_X, GROUND_Y - playerHeight };
+    Vector2 prevPlayerPos = playerPos;
     float verticalSpeed = 0.0f, currentSpeed = PLAYER_SPEED, speedTimer = 0.0f;
     bool onGround = true, gameOver = false, magnetActive = false;
     int currentFrame = 0, coinCount = 0;
     float frameCounter = 0.0f;
     float magnetTimer = 0.0f, magnetSpawnTimer = 0.0f;
-    float rockSpawnTimer = 0.0f, rockSpawnInterval = (float)disRockInterval(gen);
-    float treeSpawnTimer = 0.0f, treeSpawnInterval = (float)disTreeInterval(gen);
-    float magnetScale = (playerWidth * 0.6f) / magnetTexture.width;
-    float rockScale = (playerWidth * 1.5f) / rockTexture.width;
-    float treeScale = 0.8f;
-    float coinScale = (playerWidth * 0.5f) / coinTexture.width;
-    float icScale = playerHeight / (float)icTexture.height;
+    float rockSpawnTimer = 0.0f, rockSpawnInterval = SimRandomFloat(ROCK_SPAWN_MIN_INTERVAL, ROCK_SPAWN_MAX_INTERVAL);
+    float treeSpawnTimer = 0.0f, treeSpawnInterval = SimRandomFloat(TREE_SPAWN_MIN_INTERVAL, TREE_SPAWN_MAX_INTERVAL);
+    ArchetypeSize archSize[ARCH_COUNT];
+    archSize[ARCH_COIN] = SizeArchetype(ARCH_COIN, coinTexture.width, coinTexture.height, playerWidth, playerHeight);
+    archSize[ARCH_MAGNET] = SizeArchetype(ARCH_MAGNET, magnetTexture.width, magnetTexture.height, playerWidth, playerHeight);
+    archSize[ARCH_ROCK] = SizeArchetype(ARCH_ROCK, rockTexture.width, rockTexture.height, playerWidth, playerHeight);
+    archSize[ARCH_TREE] = SizeArchetype(ARCH_TREE, treeTexture.width, treeTexture.height, playerWidth, playerHeight);
+    archSize[ARCH_BIRD] = SizeArchetype(ARCH_BIRD, birdTexture.width, birdTexture.height, playerWidth, playerHeight);
+    archSize[ARCH_IC] = SizeArchetype(ARCH_IC, icTexture.width, icTexture.height, playerWidth, playerHeight);
+    float magnetScale = archSize[ARCH_MAGNET].scale, rockScale = archSize[ARCH_ROCK].scale;
+    float treeScale = archSize[ARCH_TREE].scale, coinScale = archSize[ARCH_COIN].scale, icScale = archSize[ARCH_IC].scale;
+    const Vector2 coinSize = archSize[ARCH_COIN].size, rockSize = archSize[ARCH_ROCK].size, icSize = archSize[ARCH_IC].size;
+    const HitMask* archMask[ARCH_COUNT] = { nullptr, nullptr, &rockMask, nullptr, &birdMask, &icMask };
+    rockMask = LoadHitMask("img/rock.png", rockScale);
+    birdMask = LoadHitMask("img/bird.png", BIRD_SCALE);
+    icMask = LoadHitMask("img/ic.png", icScale);
+    if (checkSwept) {
+        bool ok = RunSweptCheck(playerWidth, playerHeight, rockScale);
+        UnloadAssets();
+        CloseAudioDevice();
+        CloseWindow();
+        return ok ? 0 : 1;
+    }
+    if (savesEnabled) TelemetryInit("telemetry.bin"); // field data only, not check or scenario runs
+    if (savesEnabled) GhostsInit();
+    if (metricsPort > 0) {
+        if (MetricsStart(metricsPort)) TraceLog(LOG_INFO, "METRICS: serving http://127.0.0.1:%d/metrics", metricsPort);
+        else TraceLog(LOG_WARNING, "METRICS: cannot listen on 127.0.0.1:%d", metricsPort);
+    }
     int lastRunCoinCount = 0;
+    TextField lastRunCoinField = {}, magnetField = {}, bankaiCooldownField = {}, rushField = {}; // HUD numbers, formatted on change
     int health = maxHealth, mana = maxMana;
     float spawnBlockTimer = 0.0f; // For 5 second "nothing" at start
 
@@ -483,706 +1503,734 @@ int main() {
     const float BANKAI_TEXT_FADE = 1.2f;
     float bankaiCooldown = 0.0f;
 
+    int framesRun = 0;
     while (!WindowShouldClose()) {
+        if (maxFrames > 0 && framesRun++ >= maxFrames) break;
+        PacerBeginFrame();
+        ProfFrameBegin();
+        ProfEnter(PROF_INPUT);
+        MemBeginFrame();
+        FrameArenaReset();
+
+        if (autoRun && currentState != GAME) {
+            InitGameLogic(playerPos, verticalSpeed, currentSpeed, speedTimer,
+                onGround, currentFrame, frameCounter, coinCount,
+                magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                rockSpawnInterval, treeSpawnTimer, treeSpawnInterval, gameOver,
+                playerWidth, playerHeight,
+                health, mana,
+                spawnBlockTimer
+            );
+            currentState = GAME;
+            gameIntroTimer = 0.0f;
+            gameIntroActive = true;
+            dayNightTimer = 0.0f;
+            waitingNameInput = false;
+        }
+        // Hits still land but never end the run, so one run covers every rain period
+        if (autoRun) health = maxHealth;
 
-        float dt = GetFrameTime();
+        // frame time; only the render-side fades below use it
+        float dt = simulatedClock ? SIM_DT : GetFrameTime();
 
         if (isSoundOn) {
+            if (IsMusicStreamPlaying(bgm1) && bgm1.stream.sampleRate > 0 && dt > (float)IDLE_AUDIO_BUFFER / bgm1.stream.sampleRate) audioUnderruns++;
             UpdateMusicStream(bgm1);
+            AssetTouchMusic(bgm1);
             if (!IsMusicStreamPlaying(bgm1)) PlayMusicStream(bgm1);
         } else {
             PauseMusicStream(bgm1);
         }
 
-        // Sound button
-        if (CheckCollisionPointRec(GetMousePosition(), soundRect) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-            isSoundOn = !isSoundOn;
-            SaveSoundState();
-        }
-        if (currentState == GAME && !isPaused)
-            timeSinceGameStarted += dt;
-
-        if (bankaiCooldown > 0.0f) bankaiCooldown -= dt;
-        if (bankaiCooldown < 0.0f) bankaiCooldown = 0.0f;
-
-        // --------- RAIN LOGIC ---------
-        if (currentState == GAME && !isPaused && rainPeriodCount < 4) {
-            rainTimer += dt;
-            if (rainState == 0 && rainTimer >= rainNextEventTime) {
-                raining = true;
-                rainState = 1;
-                rainTimer = 0.0f;
-                rainPeriodCount++;
-                rainIntensity = 0.6f + 0.4f * ((float)GetRandomValue(0, 100) / 100.0f);
-                rainDrops.clear();
-                int dropCount = 250 + (int)(rainIntensity * 300);
-                for (int i = 0; i < dropCount; i++) {
-                    RainDrop r;
-                    r.x = (float)GetRandomValue(0, SCREEN_WIDTH);
-                    r.y = (float)GetRandomValue(0, SCREEN_HEIGHT);
-                    r.length = 16 + rainIntensity * GetRandomValue(8, 32);
-                    r.thickness = 1 + rainIntensity * GetRandomValue(1, 2);
-                    r.opacity = 0.45f + rainIntensity * 0.45f;
-                    r.speed = 600 + rainIntensity * GetRandomValue(100, 500);
-                    rainDrops.push_back(r);
-                }
-                PLAY_SOUND(rainSnd);
-                rainSoundPlaying = true;
-                thunderInterval = 2.0f + ((float)GetRandomValue(0, 300) / 100.0f);
-                thunderTimer = 0.0f;
+        // Presses since the last present that the pacer's idle wait did not queue already
+        PollInputEvents();
+        InputCollect(GetTime());
+        ProfEnter(PROF_SIM);
+        MemSetTag(MEM_TAG_ENTITIES);
+        simAccumulator += fminf(dt, MAX_FRAME_DT);
+        while (simAccumulator >= SIM_DT) {
+            simAccumulator -= SIM_DT;
+            const float dt = SIM_DT;
+            TickInput in = ConsumeInput();
+            if (in.toggleStats) showRenderStats = !showRenderStats;
+            if (in.toggleAssets) {
+                showAssets = !showAssets;
+                if (showAssets) AssetsDump(stdout);
             }
-            else if (rainState == 1 && rainTimer >= rainDuration) {
-                raining = false;
-                rainState = 0;
-                rainTimer = 0.0f;
-                rainNextEventTime = clearDuration;
-                if (rainSoundPlaying) {
-                    StopSound(rainSnd);
-                    rainSoundPlaying = false;
-                }
+            if (in.toggleSharpen) ResScaleSetSharpen(!ResScaleGetSharpen());
+            if (in.click && CheckCollisionPointRec(in.mouse, soundRect)) {
+                isSoundOn = !isSoundOn;
+                SaveSoundState();
             }
-            if (raining) {
-                thunderTimer += dt;
-                if (thunderTimer > thunderInterval) {
-                    PLAY_SOUND(thunderSnd);
-                    thunderInterval = 2.0f + ((float)GetRandomValue(0, 300) / 100.0f);
-                    thunderTimer = 0.0f;
-                }
-                for (auto &drop : rainDrops) {
-                    drop.y += drop.speed * dt;
-                    if (drop.y > SCREEN_HEIGHT) {
-                        drop.x = (float)GetRandomValue(0, SCREEN_WIDTH);
-                        drop.y = -GetRandomValue(10, 400);
+            // The exit dialog is modal: its clicks and ESC go no further
+            if (exitDialogOpen) {
+                if (in.click) {
+                    if (CheckCollisionPointRec(in.mouse, exitYesBtn)) {
+                        if (currentState == GAME || currentState == SHOP || currentState == HIGH_SCORE) {
+                            // Return to menu instead of closing game; a run is suspended, not lost
+                            bool suspended = false;
+                            if (currentState == GAME) {
+                                TelemetryEndRun(DEATH_NONE, coinCount, rainPeriodCount);
+                                if (savesEnabled) {
+                                    double startTime = GetTime();
+                                    SnapBegin(runSnapshot, SNAP_SAVE);
+                                    TransferRunState(runSnapshot, playerPos, verticalSpeed, currentSpeed, speedTimer,
+                                        onGround, currentFrame, frameCounter, coinCount,
+                                        magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                                        rockSpawnInterval, treeSpawnTimer, treeSpawnInterval,
+                                        health, mana, spawnBlockTimer, bankaiActive, bankaiCooldown);
+                                    suspended = WriteRunSnapshot(startTime);
+                                }
+                            }
+                            if (currentState == GAME && coinCount > 0 && !suspended) {
+                                if (coinCount > highScore) highScore = coinCount;
+                                totalCoins += coinCount;
+                                SaveStats();
+                            }
+                            currentState = MENU;
+                        } else {
+                            // Fully exit game in menu or other states
+                            TelemetryShutdown();
+                            MetricsStop();
+                            GhostsShutdown();
+                            SaveStats();
+                            SaveSoundState();
+                            ScoreStoreClose();
+                            SaveUpgrades();
+                            UnloadUiCaches();
+                            ResScaleUnload();
+                            TextSdfUnload();
+                            FrameArenaShutdown();
+                            UnloadAssets();
+                            AssetUnloadMusic(bgm1);
+                            CloseAudioDevice();
+                            CloseWindow();
+                            exit(0);
+                        }
+                        exitDialogOpen = false;
                     }
+                    if (CheckCollisionPointRec(in.mouse, exitNoBtn)) exitDialogOpen = false;
                 }
+                if (in.back) exitDialogOpen = false;
+                in.click = in.back = false;
+            } else if (in.click && CheckCollisionPointRec(in.mouse, exitRect)
+                       && !(currentState == GAME && spawnBlockTimer <= 5.0f)) { // the icon is not drawn then
+                exitDialogOpen = true;
+                in.click = false;
             }
-        } else if ((isPaused || currentState != GAME) && rainSoundPlaying) {
-            PauseSound(rainSnd);
-        } else if (!isPaused && currentState == GAME && raining && !IsSoundPlaying(rainSnd)) {
-            ResumeSound(rainSnd);
-        }
-
-        // ---- BANKAI trigger (B KEY) ----
-        if ((currentState == GAME) && !bankaiActive && bankaiCooldown <= 0.0f && IsKeyPressed(KEY_B)) {
-            if (mana >= getBankaiCost()) {
-                bankaiActive = true;
-                bankaiFlashTimer = 0.25f;
-                bankaiTextAlpha = 1.0f;
-                PLAY_SOUND(bankaiSnd);
-                mana -= getBankaiCost();
-                if (mana < 0) mana = 0;
-                bankaiCooldown = getBankaiCooldown();
-                for (auto& c : coins) c.active = false;
-                rocks.clear();
-                trees.clear();
-                magnets.clear();
-                ic.active = false;
-                ic.destroyed = false;
-            } else {
-                lowManaMsg = true;
-                lowManaMsgTimer = BANKAI_TEXT_FADE;
-            }
-        }
-
-        if (currentState == GAME && !isPaused) {
-            bg1Offset += bgScrollSpeed * dt;
-            if (bg1Offset >= bg1.width) bg1Offset -= bg1.width;
-            bg2Offset += bgScrollSpeed * dt;
-            if (bg2Offset >= bg2.width) bg2Offset -= bg2.width;
-        } else {
-            bg1Offset = 0;
-            bg2Offset = 0;
-        }
-
-        Vector2 mouse = GetMousePosition();
-
-        // ---- MENU/INPUT ----
-        if (currentState == MENU) {
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                Vector2 mouse = GetMousePosition();
-                if (CheckCollisionPointRec(mouse, workshopRect)) {
-                    currentState = SHOP;
-                }
-                else if (CheckCollisionPointRec(mouse, highScoreRect)) {
-                    currentState = HIGH_SCORE;
-                }
-                else if (CheckCollisionPointRec(mouse, exitRect)) {
-                    exitDialogOpen = true;
+            if (exportPath && currentState == GAME) in.jump = AutopilotWantsJump(playerPos, playerWidth, currentSpeed, onGround);
+            if (currentState == SHOP && in.click) ShopClick(in.mouse);
+            if (currentState == GAME_OVER_STATE) {
+                bool toMenu = false;
+                if (waitingNameInput) {
+                    for (int i = 0; i < in.charCount; i++) {
+                        int key = in.chars[i];
+                        int len = strlen(nameInput);
+                        if ((key >= 32) && (key <= 125) && (len < MAX_NAME_LEN)) {
+                            nameInput[len] = (char)key;
+                            nameInput[len+1] = '\0';
+                        }
+                    }
+                    if (in.erase) {
+                        int len = strlen(nameInput);
+                        if (len > 0) nameInput[len-1] = '\0';
+                    }
+                    if (in.enter && strlen(nameInput) > 0) {
+                        ScoreStoreSetName(insertIndex, nameInput);
+                        GhostRecordSave(nameInput, lastRunCoinCount, insertIndex);
+                        RefreshHighScores();
+                        waitingNameInput = false;
+                        strcpy(nameInput, "");
+                        toMenu = true;
+                    }
+                } else if (in.click || in.anyKey) {
+                    toMenu = true;
                 }
-                // Only start if click is inside "tap to start" rect
-                else if (CheckCollisionPointRec(mouse, tapToStartRect)) {
+                if (toMenu) {
+                    currentState = MENU;
+                    playerPos.x = PLAYER_X;
+                    playerPos.y = GROUND_Y - playerHeight;
+                    verticalSpeed = 0;
+                    onGround = true;
                     standUpCurrentFrame = 0;
-                    standUpFrameTimer = 0.0f;
-                    InitGameLogic(playerPos, verticalSpeed, currentSpeed, speedTimer,
+                }
+                // The press is used up here, not by the menu's next tick
+                Vector2 mouse = in.mouse;
+                in = TickInput{};
+                in.mouse = mouse;
+            }
+            SnapshotSimState();
+            prevPlayerPos = playerPos;
+            if (currentState == GAME && !isPaused)
+                timeSinceGameStarted += dt;
+            if (scenario && currentState == GAME && !isPaused)
+                ApplyScenarioLoad(magnetActive, magnetTimer, coinScale, playerHeight);
+
+            // Rewind: a held R replaces the tick with the one before it; otherwise the tick's start is kept
+            rewinding = false;
+            if (currentState == GAME && !isPaused && !scenario && rushTimer <= 0.0f) {
+                if (in.rewind && RewindStep(&rewindState, sizeof(rewindState))) {
+                    SyncWorldState(rewindState, true, playerPos, verticalSpeed, currentSpeed, speedTimer,
                         onGround, currentFrame, frameCounter, coinCount,
                         magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
-                        rockSpawnInterval, treeSpawnTimer, treeSpawnInterval, gameOver,
-                        playerWidth, playerHeight,
-                        health, mana,
-                        spawnBlockTimer
-                    );
-                    currentState = STANDUP;
+                        rockSpawnInterval, treeSpawnTimer, treeSpawnInterval,
+                        health, mana, spawnBlockTimer, bankaiCooldown);
+                    SnapshotSimState();
+                    prevPlayerPos = playerPos;
+                    GhostsAbandonRace(); // a rewound run is no longer a clean ghost
+                    rewinding = true;
+                    continue;
                 }
-                // Else: clicked outside, do nothing!
+                SyncWorldState(rewindState, false, playerPos, verticalSpeed, currentSpeed, speedTimer,
+                        onGround, currentFrame, frameCounter, coinCount,
+                        magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                        rockSpawnInterval, treeSpawnTimer, treeSpawnInterval,
+                        health, mana, spawnBlockTimer, bankaiCooldown);
+                RewindPush(&rewindState, sizeof(rewindState));
             }
-            if (IsKeyPressed(KEY_RIGHT)) { currentState = ZEN_TRANSITION; transitionX = 0; }
-        }
 
+            if (bankaiCooldown > 0.0f) bankaiCooldown -= dt;
+            if (bankaiCooldown < 0.0f) bankaiCooldown = 0.0f;
 
-        else if (currentState == STANDUP) {
-            standUpFrameTimer += dt;
-            if (standUpFrameTimer >= standUpFrameDuration) {
-                standUpFrameTimer = 0.0f;
-                standUpCurrentFrame++;
-                if (standUpCurrentFrame >= NUM_STANDUP_FRAMES) {
-                    currentState = GAME;
-                    gameIntroTimer = 0.0f;
-                    gameIntroActive = true;
-                    dayNightTimer = 0.0f;
-                    spawnBlockTimer = 0.0f;
+            // --------- RAIN LOGIC ---------
+            if (currentState == GAME && !isPaused && rainPeriodCount < 4) {
+                rainTimer += dt;
+                if (rainState == 0 && rainTimer >= rainNextEventTime) {
+                    rainPeriodCount++;
+                    StartRain(0.6f + 0.4f * ((float)SimRandomValue(0, 100) / 100.0f));
                 }
-            }
-        }
-        else if (currentState == ZEN_MODE && IsKeyPressed(KEY_LEFT)) {
-            currentState = ZEN_TRANSITION_BACK; transitionX = SCREEN_WIDTH;
-        }
-        else if ((currentState == GAME || currentState == SHOP || currentState == HIGH_SCORE)
-                    && (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_BACKSPACE))) {
-            if (currentState == GAME && coinCount > 0) {
-                if (coinCount > highScore) highScore = coinCount;
-                totalCoins += coinCount;
-                SaveStats();
-            }
-            currentState = MENU;
-        }
-        if (currentState == ZEN_TRANSITION) {
-            transitionX += transitionSpeed * dt;
-            if (transitionX >= SCREEN_WIDTH) { transitionX = SCREEN_WIDTH; currentState = ZEN_MODE; }
-        } else if (currentState == ZEN_TRANSITION_BACK) {
-            transitionX -= transitionSpeed * dt;
-            if (transitionX <= 0) { transitionX = 0; currentState = MENU; }
-        }
-
-        // -------- GAME LOGIC --------
-        float effectiveSpeed = currentSpeed;
-        if (raining) effectiveSpeed *= 0.95f;
-        if (currentState == GAME) {
-            if (!gameIntroActive && CheckCollisionPointRec(mouse, pauseRect) && !CheckCollisionPointRec(mouse, soundRect) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                isPaused = !isPaused;
-            }
-            if (!isPaused) {
-                if (gameIntroActive) {
-                    gameIntroTimer += dt;
-                    if (gameIntroTimer >= GAME_INTRO_DURATION) {
-                        gameIntroActive = false;
+                else if (rainState == 1 && rainTimer >= rainDuration) {
+                    raining = false;
+                    rainState = 0;
+                    rainTimer = 0.0f;
+                    rainNextEventTime = clearDuration;
+                    if (rainSoundPlaying) {
+                        StopSound(rainSnd);
+                        rainSoundPlaying = false;
                     }
                 }
-                speedTimer += dt;
-                if (speedTimer >= 1.0f) { currentSpeed += 0.1f; speedTimer = 0.0f; }
-                if (icSlowing) {
-                    icSlowTimer -= dt;
-                    if (icSlowTimer <= 0.0f) {
-                        icSlowing = false;
-                        currentSpeed = PLAYER_SPEED + (currentSpeed - PLAYER_SPEED) * 0.0f;
+                if (raining) {
+                    thunderTimer += dt;
+                    if (thunderTimer > thunderInterval) {
+                        PLAY_SOUND(thunderSnd);
+                        thunderInterval = 2.0f + ((float)SimRandomValue(0, 300) / 100.0f);
+                        thunderTimer = 0.0f;
                     }
+                    UpdateRainDrops(rainDrops, QualityWeatherCount((int)rainDrops.size()), dt);
                 }
-                if (IsKeyPressed(KEY_SPACE) && onGround && mana >= 1) {
-                    verticalSpeed = JUMP_FORCE; onGround = false;
-                    mana -= 1;
+            } else if ((isPaused || currentState != GAME) && rainSoundPlaying) {
+                PauseSound(rainSnd);
+            } else if (!isPaused && currentState == GAME && raining && !IsSoundPlaying(rainSnd)) {
+                ResumeSound(rainSnd);
+            }
+
+            // ---- BANKAI trigger (B KEY) ----
+            if ((currentState == GAME) && !bankaiActive && bankaiCooldown <= 0.0f && in.bankai) {
+                if (mana >= getBankaiCost()) {
+                    bankaiActive = true;
+                    bankaiFlashTimer = 0.25f;
+                    bankaiTextAlpha = 1.0f;
+                    PLAY_SOUND(bankaiSnd);
+                    mana -= getBankaiCost();
                     if (mana < 0) mana = 0;
-                }
-                const float manaRegenPerSecond = 0.5f;
-                if (mana < maxMana) {
-                    manaRegenAccumulator += manaRegenPerSecond * dt;
-                    while (manaRegenAccumulator >= 1.0f && mana < maxMana) {
-                        mana++;
-                        manaRegenAccumulator -= 1.0f;
-                    }
-                    if (mana > maxMana) mana = maxMana;
-                }
-                verticalSpeed += GRAVITY;
-                playerPos.y += verticalSpeed;
-                if (playerPos.y >= GROUND_Y - playerHeight) { playerPos.y = GROUND_Y - playerHeight; verticalSpeed = 0.0f; onGround = true; }
-                if (onGround) {
-                    frameCounter += dt;
-                    if (frameCounter >= 0.10f) { frameCounter = 0.0f; currentFrame = (currentFrame + 1) % playerFrames.size(); }
+                    bankaiCooldown = getBankaiCooldown();
+                    for (auto& c : coins) c.active = false;
+                    rocks.clear();
+                    trees.clear();
+                    magnets.clear();
+                    ic.active = false;
+                    ic.destroyed = false;
                 } else {
-                    if (verticalSpeed < -5.0f) currentFrame = 0;
-                    else if (verticalSpeed < -1.0f) currentFrame = 1;
-                    else if (verticalSpeed < 2.0f) currentFrame = 2;
-                    else currentFrame = 3;
+                    lowManaMsg = true;
+                    lowManaMsgTimer = BANKAI_TEXT_FADE;
                 }
-                if (!isPaused) dayNightTimer += dt;
-                // ----- SPAWN-BLOCK: 5 seconds delay -----
-                spawnBlockTimer += dt;
-                bool canSpawn = (spawnBlockTimer > 5.0f);
-
-                // Only spawn/animate entities after 5 seconds
-                if (!gameIntroActive && canSpawn) {
-                    magnetSpawnTimer += dt;
-                    if (magnetSpawnTimer >= MAGNET_SPAWN_INTERVAL) {
-                        magnetSpawnTimer = 0.0f;
-                        float x = playerPos.x + SCREEN_WIDTH + GetRandomValue(200, 800);
-                        float y = (float)GetRandomValue(500, 600);
-                        magnets.push_back({ { x, y }, true });
-                    }
-                    rockSpawnTimer += dt;
-                    if (rockSpawnTimer >= rockSpawnInterval) {
-                        rockSpawnTimer = 0.0f; rockSpawnInterval = (float)disRockInterval(gen);
-                        bool validPosition = false; int attempts = 0;
-                        while (!validPosition && attempts < 20) {
-                            float x = playerPos.x + SCREEN_WIDTH + GetRandomValue(300, 1000);
-                            float y = GROUND_Y - 110;
-                            bool overlapsWithCoin = false;
-                            for (const auto& c : coins) {
-                                if (c.active) {
-                                    float coinWidth = coinTexture.width * coinScale;
-                                    float coinHeight = coinTexture.height * coinScale;
-                                    if (x < c.position.x + coinWidth + 50 &&
-                                        x + rockTexture.width * rockScale > c.position.x - 50 &&
-                                        y < c.position.y + coinHeight + 50 &&
-                                        y + rockTexture.height * rockScale > c.position.y - 50) {
-                                        overlapsWithCoin = true; break;
-                                    }
-                                }
-                            }
-                            bool overlapsWithRock = false;
-                            for (const auto& r : rocks) {
-                                if (r.active) {
-                                    if (x < r.position.x + rockTexture.width * rockScale + 100 &&
-                                        x + rockTexture.width * rockScale > r.position.x - 100) {
-                                        overlapsWithRock = true; break;
-                                    }
-                                }
-                            }
-                            if (!overlapsWithCoin && !overlapsWithRock) {
-                                rocks.push_back({ { x, y }, true }); validPosition = true;
-                            } else attempts++;
-                        }
+            }
+
+            if (currentState == GAME && !isPaused) {
+                bg1Offset += bgScrollSpeed * dt;
+                if (bg1Offset >= bg1.width) bg1Offset -= bg1.width;
+                bg2Offset += bgScrollSpeed * dt;
+                if (bg2Offset >= bg2.width) bg2Offset -= bg2.width;
+            } else {
+                bg1Offset = 0;
+                bg2Offset = 0;
+            }
+
+            Vector2 mouse = in.mouse;
+
+            // ---- MENU/INPUT ----
+            if (currentState == MENU) {
+                if (in.click) {
+                    if (CheckCollisionPointRec(mouse, workshopRect)) {
+                        currentState = SHOP;
                     }
-                    treeSpawnTimer += dt;
-                    if (treeSpawnTimer >= treeSpawnInterval) {
-                        treeSpawnTimer = 0.0f; treeSpawnInterval = (float)disTreeInterval(gen);
-                        float x = playerPos.x + SCREEN_WIDTH + GetRandomValue(200, 600);
-                        float y = GROUND_Y - treeTexture.height * treeScale + 45;
-                        trees.push_back({ { x, y }, treeScale, true });
+                    else if (CheckCollisionPointRec(mouse, highScoreRect)) {
+                        currentState = HIGH_SCORE;
                     }
-                    // === BIRD SPAWNING ===
-                    birdSpawnTimer += dt;
-                    if (birdSpawnTimer >= birdSpawnInterval) {
-                        birdSpawnTimer = 0.0f;
-                        birdSpawnInterval = 3.0f + (float)GetRandomValue(0, 200)/50.0f;
-
-                        float x = playerPos.x + SCREEN_WIDTH + GetRandomValue(300, 900);
-
-                        // Jump-over bird Y positioning
-                        float playerBaseY = GROUND_Y - playerHeight;
-                        float minBirdY = playerBaseY - 180;
-                        float maxBirdY = playerBaseY - 160;
-                        float y = (float)GetRandomValue((int)minBirdY, (int)maxBirdY);
-
-                        float scale = 0.25f;
-                        float speed = effectiveSpeed + 5.0f + GetRandomValue(0, 50)/10.0f;
-                        birds.push_back({ {x, y}, speed, scale, true });
+                    else if (CheckCollisionPointRec(mouse, exitRect)) {
+                        exitDialogOpen = true;
                     }
-
-                    // === UPDATE BIRDS ===
-                    for (auto it = birds.begin(); it != birds.end();) {
-                        if (it->active) {
-                            it->position.x -= it->speed;
-                            if (it->position.x < -birdTexture.width * it->scale) {
-                                it = birds.erase(it);
-                                continue;
+                    // Only start if click is inside "tap to start" rect
+                    else if (CheckCollisionPointRec(mouse, tapToStartRect)) {
+                        standUpCurrentFrame = 0;
+                        standUpFrameTimer = 0.0f;
+                        InitGameLogic(playerPos, verticalSpeed, currentSpeed, speedTimer,
+                            onGround, currentFrame, frameCounter, coinCount,
+                            magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                            rockSpawnInterval, treeSpawnTimer, treeSpawnInterval, gameOver,
+                            playerWidth, playerHeight,
+                            health, mana,
+                            spawnBlockTimer
+                        );
+                        currentState = STANDUP;
+                        if (runSuspended) {
+                            double startTime = GetTime();
+                            bool resumed = SnapReadFile(runSnapshot, RUN_SNAPSHOT_FILE, RUN_SNAPSHOT_VERSION, RunSnapshotLayout());
+                            if (resumed) {
+                                TransferRunState(runSnapshot, playerPos, verticalSpeed, currentSpeed, speedTimer,
+                                    onGround, currentFrame, frameCounter, coinCount,
+                                    magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                                    rockSpawnInterval, treeSpawnTimer, treeSpawnInterval,
+                                    health, mana, spawnBlockTimer, bankaiActive, bankaiCooldown);
+                                resumed = runSnapshot.ok;
                             }
-                            // --- Collision with player ---
-                            Rectangle birdRect = { it->position.x, it->position.y,
-                                birdTexture.width * it->scale, birdTexture.height * it->scale
-                            };
-                            Rectangle playerRect = { playerPos.x, playerPos.y, playerWidth, playerHeight };
-                            if (CheckCollisionRecs(birdRect, playerRect)) {
-                                it->active = false;
-                                // --- COLLISION CONSEQUENCE (EXAMPLE): ---
-                                // e.g., reset coin count and damage player
-                                lastRunCoinCount = coinCount;
-                                health -= 30;
-                                if(coinCount>2) coinCount -= 3; // you can change this effect
-                                else coinCount=0;
-                                if (health <= 0) {
-                                    health = 0;
-                                    if (coinCount > highScore) highScore = coinCount;
-                                    totalCoins += coinCount;
-                                    SaveStats();
-                                    currentState = GAME_OVER_STATE;
-                                    bankaiActive = false;
-                                    bankaiFlashTimer = 0.0f;
-                                    bankaiTextAlpha = 0.0f;
-                                    bankaiCooldown = 0.0f;
-                                    goto drawSection;
-                                }
+                            if (resumed) {
+                                TraceLog(LOG_INFO, "SNAPSHOT: run resumed (%d bytes, %.2f ms)", (int)runSnapshot.bytes.size(), (GetTime() - startTime) * 1000.0);
+                                SnapshotSimState();
+                                prevPlayerPos = playerPos;
+                                GhostsAbandonRace();
+                                currentState = GAME;
+                                isPaused = true; // continue on the player's click
+                            } else {
+                                TraceLog(LOG_WARNING, "SNAPSHOT: %s is unreadable, starting a new run", RUN_SNAPSHOT_FILE);
+                                InitGameLogic(playerPos, verticalSpeed, currentSpeed, speedTimer,
+                                    onGround, currentFrame, frameCounter, coinCount,
+                                    magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                                    rockSpawnInterval, treeSpawnTimer, treeSpawnInterval, gameOver,
+                                    playerWidth, playerHeight,
+                                    health, mana,
+                                    spawnBlockTimer
+                                );
                             }
+                            remove(RUN_SNAPSHOT_FILE);
+                            runSuspended = false;
                         }
-                        ++it;
                     }
+                    // Else: clicked outside, do nothing!
                 }
+                if (in.right) { currentState = ZEN_TRANSITION; transitionX = 0; }
+            }
+
 
-                // All entity updates and collisions are only allowed after 5 seconds
-                if (!gameIntroActive && canSpawn) {
-                    if (magnetActive) { magnetTimer -= dt; if (magnetTimer <= 0.0f) magnetActive = false; }
-                    Vector2 playerCenter = { playerPos.x + playerWidth / 2.0f, playerPos.y + playerHeight / 2.0f };
-                    Rectangle playerRect = { playerPos.x, playerPos.y, playerWidth, playerHeight };
-                    for (auto it = burstParticles.begin(); it != burstParticles.end(); ) {
-                        it->position.x += it->velocity.x * dt;
-                        it->position.y += it->velocity.y * dt;
-                        it->velocity.y += 800.0f * dt;
-                        it->life -= dt;
-                        if (it->life <= 0.0f) it = burstParticles.erase(it); else ++it;
+            else if (currentState == STANDUP) {
+                standUpFrameTimer += dt;
+                if (standUpFrameTimer >= standUpFrameDuration) {
+                    standUpFrameTimer = 0.0f;
+                    standUpCurrentFrame++;
+                    if (standUpCurrentFrame >= NUM_STANDUP_FRAMES) {
+                        currentState = GAME;
+                        gameIntroTimer = 0.0f;
+                        gameIntroActive = true;
+                        dayNightTimer = 0.0f;
+                        spawnBlockTimer = 0.0f;
                     }
+                }
+            }
+            else if (currentState == ZEN_MODE && in.left) {
+                currentState = ZEN_TRANSITION_BACK; transitionX = SCREEN_WIDTH;
+            }
+            else if ((currentState == GAME || currentState == SHOP || currentState == HIGH_SCORE)
+                        && in.back) {
+                if (currentState == GAME) TelemetryEndRun(DEATH_NONE, coinCount, rainPeriodCount);
+                if (currentState == GAME && coinCount > 0) {
+                    if (coinCount > highScore) highScore = coinCount;
+                    totalCoins += coinCount;
+                    SaveStats();
+                }
+                currentState = MENU;
+            }
+            if (currentState == ZEN_TRANSITION) {
+                transitionX += transitionSpeed * dt;
+                if (transitionX >= SCREEN_WIDTH) { transitionX = SCREEN_WIDTH; currentState = ZEN_MODE; }
+            } else if (currentState == ZEN_TRANSITION_BACK) {
+                transitionX -= transitionSpeed * dt;
+                if (transitionX <= 0) { transitionX = 0; currentState = MENU; }
+            }
 
-                    icSpawnTimer += dt;
-                    if (!ic.active && !ic.destroyed && icSpawnTimer >= icSpawnInterval) {
-                        icSpawnTimer = 0.0f;
-                        icSpawnInterval = (float)disIcInterval(gen);
-                        bool valid = false; int tries = 0;
-                        while (!valid && tries < 20) {
-                            float x = playerPos.x + SCREEN_WIDTH + GetRandomValue(350, 1000);
-                            float y = GROUND_Y - icTexture.height * icScale;
-                            Rectangle icRect = { x, y, icTexture.width * icScale, icTexture.height * icScale };
-                            bool overlapsRock = false;
-                            for (const auto& r : rocks) {
-                                if (r.active) {
-                                    Rectangle rockRect = { r.position.x, r.position.y, rockTexture.width * rockScale, rockTexture.height * rockScale };
-                                    if (CheckCollisionRecs(icRect, rockRect)) { overlapsRock = true; break; }
-                                }
-                            }
-                            if (!overlapsRock) {
-                                ic.position = { x, y };
-                                ic.active = true;
-                                ic.destroyed = false;
-                                ic.destroyTimer = 0;
-                                valid = true;
-                            }
-                            tries++;
+            // -------- GAME LOGIC --------
+            float effectiveSpeed = currentSpeed;
+            if (raining) effectiveSpeed *= 0.95f;
+            if (scenario) effectiveSpeed *= scenario->speedScale;
+            if (currentState == GAME) {
+                if (!gameIntroActive && CheckCollisionPointRec(mouse, pauseRect) && !CheckCollisionPointRec(mouse, soundRect) && in.click) {
+                    isPaused = !isPaused;
+                }
+                if (!isPaused) {
+                    if (gameIntroActive) {
+                        gameIntroTimer += dt;
+                        if (gameIntroTimer >= GAME_INTRO_DURATION) {
+                            gameIntroActive = false;
                         }
                     }
-
-                    if (ic.active && !ic.destroyed) {
-                        ic.position.x -= effectiveSpeed;
-                        if (ic.position.x < -icTexture.width * icScale) ic.active = false;
-                        Rectangle icRect = { ic.position.x, ic.position.y, icTexture.width * icScale, icTexture.height * icScale };
-                        if (CheckCollisionRecs(icRect, playerRect)) {
-                            ic.active = false;
-                            ic.destroyed = true;
-                            ic.destroyTimer = 2.0f;
-                            icSlowing = true;
-                            icSlowTimer = 4.0f;
-                            currentSpeed *= 0.8f;
+                    speedTimer += dt;
+                    if (speedTimer >= 1.0f) { currentSpeed += 0.1f; speedTimer = 0.0f; }
+                    if (icSlowing) {
+                        icSlowTimer -= dt;
+                        if (icSlowTimer <= 0.0f) {
+                            icSlowing = false;
+                            currentSpeed = PLAYER_SPEED + (currentSpeed - PLAYER_SPEED) * 0.0f;
                         }
                     }
-                    if (ic.destroyed) {
-                        ic.destroyTimer -= dt;
-                        if (ic.destroyTimer <= 0) {
-                            ic.destroyed = false;
+                    if (in.jump && onGround && mana >= 1) {
+                        verticalSpeed = JUMP_FORCE; onGround = false;
+                        mana -= 1;
+                        if (mana < 0) mana = 0;
+                    }
+                    const float manaRegenPerSecond = 0.5f;
+                    if (mana < maxMana) {
+                        manaRegenAccumulator += manaRegenPerSecond * dt;
+                        while (manaRegenAccumulator >= 1.0f && mana < maxMana) {
+                            mana++;
+                            manaRegenAccumulator -= 1.0f;
                         }
+                        if (mana > maxMana) mana = maxMana;
                     }
-
-                    for (const auto& r : rocks) {
-                        if (r.active) {
-                            Rectangle rockRect = { r.position.x, r.position.y, rockTexture.width * rockScale, rockTexture.height * rockScale };
-                            if (CheckCollisionRecs(playerRect, rockRect)) {
+                    verticalSpeed += GRAVITY;
+                    playerPos.y += verticalSpeed;
+                    if (playerPos.y >= GROUND_Y - playerHeight) { playerPos.y = GROUND_Y - playerHeight; verticalSpeed = 0.0f; onGround = true; }
+                    if (onGround) {
+                        frameCounter += dt;
+                        if (frameCounter >= 0.10f) { frameCounter = 0.0f; currentFrame = (currentFrame + 1) % playerFrames.size(); }
+                    } else {
+                        if (verticalSpeed < -5.0f) currentFrame = 0;
+                        else if (verticalSpeed < -1.0f) currentFrame = 1;
+                        else if (verticalSpeed < 2.0f) currentFrame = 2;
+                        else currentFrame = 3;
+                    }
+                    if (!isPaused) dayNightTimer += dt;
+                    // ----- SPAWN-BLOCK: 5 seconds delay -----
+                    spawnBlockTimer += dt;
+                    bool canSpawn = (spawnBlockTimer > 5.0f);
+                    GhostRecordTick(playerPos.y, onGround ? currentFrame : 4 + currentFrame, (!gameIntroActive && canSpawn) ? effectiveSpeed : 0.0f);
+                    GhostsTick();
+
+                    // The player over this tick, for the swept tests of every archetype kernel
+                    PlayerTick player;
+                    player.mask = onGround ? &playerRunMasks[currentFrame] : &playerJumpMasks[currentFrame];
+                    player.start = { prevPlayerPos.x, prevPlayerPos.y, playerWidth, playerHeight };
+                    player.delta = { playerPos.x - prevPlayerPos.x, playerPos.y - prevPlayerPos.y };
+                    player.center = { playerPos.x + playerWidth / 2.0f, playerPos.y + playerHeight / 2.0f };
+                    player.magnetOn = false;
+                    player.magnetRadius = MAGNET_RADIUS;
+                    player.magnetStep = 300.0f * dt;
+                    ArchetypeHit hits[MAX_TICK_HITS];
+                    // Applies one hit of the kernels below; true when it ended the run
+                    auto applyHit = [&](ArchetypeId id, const ArchetypeHit& hit) -> bool {
+                        const Archetype& a = ARCHETYPES[id];
+                        switch (a.response) {
+                            case HIT_COIN:
+                                coinCount++;
+                                SpawnCoinBurst(burstParticles, hit.at); // where the coin was at the moment of pickup
+                                break;
+                            case HIT_MAGNET:
+                                magnetActive = true;
+                                magnetTimer = MAGNET_DURATION;
+                                break;
+                            case HIT_SLOW:
+                                ic.destroyed = true;
+                                ic.destroyTimer = 2.0f;
+                                icSlowing = true;
+                                icSlowTimer = 4.0f;
+                                currentSpeed *= 0.8f;
+                                break;
+                            case HIT_DAMAGE:
                                 lastRunCoinCount = coinCount;
-                                health -= 40;
+                                health -= a.damage;
+                                coinCount = std::max(0, coinCount - a.coinPenalty);
                                 if (health <= 0) {
                                     health = 0;
                                     if (coinCount > highScore) highScore = coinCount;
                                     totalCoins += coinCount;
                                     SaveStats();
                                     currentState = GAME_OVER_STATE;
+                                    TelemetryEndRun(a.death, coinCount, rainPeriodCount);
+                                    RecordRun(lastRunCoinCount);
                                     bankaiActive = false;
                                     bankaiFlashTimer = 0.0f;
                                     bankaiTextAlpha = 0.0f;
                                     bankaiCooldown = 0.0f;
-                                    goto drawSection;
+                                    return true;
                                 }
-                                const_cast<Rock&>(r).active = false;
-                            }
+                                break;
+                            case HIT_NONE: break;
                         }
-                    }
-                    int activeCoinCount = 0;
-                    for (const auto& c : coins) if (c.active) activeCoinCount++;
-                    for (auto& c : coins) {
-                        if (c.active) {
-                            if (magnetActive) {
-                                Vector2 coinCenter = { c.position.x + (coinTexture.width * coinScale) / 2.0f, c.position.y + (coinTexture.height * coinScale) / 2.0f };
-                                float dist = Distance(playerCenter, coinCenter);
-                                if (dist < MAGNET_RADIUS && dist > 5.0f) {
-                                    Vector2 direction = { playerCenter.x - coinCenter.x, playerCenter.y - coinCenter.y };
-                                    direction = Normalize(direction);
-                                    float attractionSpeed = 300.0f * dt;
-                                    c.position.x += direction.x * attractionSpeed;
-                                    c.position.y += direction.y * attractionSpeed;
-                                }
-                            }
-                            Rectangle coinRect = { c.position.x, c.position.y, coinTexture.width * coinScale, coinTexture.height * coinScale };
-                            if (CheckCollisionRecs(playerRect, coinRect)) {
-                                c.active = false; coinCount++; activeCoinCount--;
-                                Vector2 burstPos = { c.position.x + (coinTexture.width * coinScale)/2, c.position.y + (coinTexture.height * coinScale)/2 };
-                                SpawnCoinBurst(burstParticles, burstPos);
-                            }
+                        return false;
+                    };
+
+                    // Only spawn/animate entities after 5 seconds
+                    if (!gameIntroActive && canSpawn) {
+                        magnetSpawnTimer += dt;
+                        if (magnetSpawnTimer >= MAGNET_SPAWN_INTERVAL && PoolHasRoom(magnets)) {
+                            magnetSpawnTimer = 0.0f;
+                            float x = playerPos.x + SCREEN_WIDTH + SimRandomValue(200, 800);
+                            float y = (float)SimRandomValue(500, 600);
+                            magnets.push_back({ { x, y }, true, { x, y } });
                         }
-                        c.position.x -= effectiveSpeed;
-                        if (c.position.x < -coinTexture.width && activeCoinCount < 20) {
+                        rockSpawnTimer += dt;
+                        if (rockSpawnTimer >= rockSpawnInterval && PoolHasRoom(rocks)) {
+                            rockSpawnTimer = 0.0f; rockSpawnInterval = SimRandomFloat(ROCK_SPAWN_MIN_INTERVAL, ROCK_SPAWN_MAX_INTERVAL);
                             bool validPosition = false; int attempts = 0;
                             while (!validPosition && attempts < 20) {
-                                float newX = playerPos.x + SCREEN_WIDTH + GetRandomValue(300, 1000);
-                                float newY = (float)GetRandomValue(500, 630);
+                                float x = playerPos.x + SCREEN_WIDTH + SimRandomValue(300, 1000);
+                                float y = GROUND_Y - 110;
+                                Rectangle rockArea = { x, y, rockSize.x, rockSize.y };
+                                bool overlapsWithCoin = OverlapsAnyActive(coins, rockArea, coinSize, { 50, 50 });
                                 bool overlapsWithRock = false;
-                                float coinWidth = coinTexture.width * coinScale;
-                                float coinHeight = coinTexture.height * coinScale;
                                 for (const auto& r : rocks) {
                                     if (r.active) {
-                                        if (newX < r.position.x + rockTexture.width * rockScale + 50 &&
-                                            newX + coinWidth > r.position.x - 50 &&
-                                            newY < r.position.y + rockTexture.height * rockScale + 50 &&
-                                            newY + coinHeight > r.position.y - 50) {
+                                        if (x < r.position.x + rockSize.x + 100 &&
+                                            x + rockSize.x > r.position.x - 100) {
                                             overlapsWithRock = true; break;
                                         }
                                     }
                                 }
-                                bool overlapsWithCoin = false;
-                                for (const auto& existing : coins) {
-                                    if (existing.active && &existing != &c) {
-                                        float dx = fabsf(newX - existing.position.x);
-                                        float dy = fabsf(newY - existing.position.y);
-                                        if (dx < coinWidth + 32.0f && dy < coinHeight + 40.0f) { overlapsWithCoin = true; break; }
-                                    }
-                                }
-                                if (!overlapsWithRock && !overlapsWithCoin) {
-                                    c.position.x = newX; c.position.y = newY;
-                                    c.active = true; activeCoinCount++; validPosition = true;
+                                if (!overlapsWithCoin && !overlapsWithRock) {
+                                    rocks.push_back({ { x, y }, true, { x, y } }); validPosition = true;
                                 } else attempts++;
                             }
-                            if (!validPosition) {
-                                c.position.x = playerPos.x + SCREEN_WIDTH + GetRandomValue(300, 1000);
-                                c.position.y = (float)GetRandomValue(500, 630);
-                                c.active = true; activeCoinCount++;
-                            }
                         }
+                        treeSpawnTimer += dt;
+                        if (treeSpawnTimer >= treeSpawnInterval && PoolHasRoom(trees)) {
+                            treeSpawnTimer = 0.0f; treeSpawnInterval = SimRandomFloat(TREE_SPAWN_MIN_INTERVAL, TREE_SPAWN_MAX_INTERVAL);
+                            float x = playerPos.x + SCREEN_WIDTH + SimRandomValue(200, 600);
+                            float y = GROUND_Y - treeTexture.height * treeScale + 45;
+                            trees.push_back({ { x, y }, treeScale, true, { x, y } });
+                        }
+                        // === BIRD SPAWNING ===
+                        birdSpawnTimer += dt;
+                        if (birdSpawnTimer >= birdSpawnInterval && PoolHasRoom(birds)) {
+                            birdSpawnTimer = 0.0f;
+                            birdSpawnInterval = 3.0f + (float)SimRandomValue(0, 200)/50.0f;
+
+                            float x = playerPos.x + SCREEN_WIDTH + SimRandomValue(300, 900);
+
+                            // Jump-over bird Y positioning
+                            float playerBaseY = GROUND_Y - playerHeight;
+                            float minBirdY = playerBaseY - 180;
+                            float maxBirdY = playerBaseY - 160;
+                            float y = (float)SimRandomValue((int)minBirdY, (int)maxBirdY);
+
+                            float scale = BIRD_SCALE;
+                            float speed = effectiveSpeed + 5.0f + SimRandomValue(0, 50)/10.0f;
+                            birds.push_back({ {x, y}, speed, scale, true, {x, y} });
+                        }
+
+                        // === UPDATE BIRDS ===
+                        int birdHits = StepArchetype<ARCH_BIRD>(birds, archSize[ARCH_BIRD], archMask[ARCH_BIRD], player,
+                            effectiveSpeed, hits, MAX_TICK_HITS);
+                        for (int i = 0; i < birdHits; i++)
+                            if (applyHit(ARCH_BIRD, hits[i])) goto drawSection;
                     }
 
-                    for (auto it = magnets.begin(); it != magnets.end();) {
-                        if (it->active) {
-                            Rectangle magnetRect = { it->position.x, it->position.y, magnetTexture.width * magnetScale, magnetTexture.height * magnetScale };
-                            if (CheckCollisionRecs(playerRect, magnetRect)) { it->active = false; magnetActive = true; magnetTimer = MAGNET_DURATION; }
+                    // All entity updates and collisions are only allowed after 5 seconds
+                    if (!gameIntroActive && canSpawn) {
+                        if (magnetActive) { magnetTimer -= dt; if (magnetTimer <= 0.0f) magnetActive = false; }
+                        player.magnetOn = magnetActive;
+                        UpdateBurstParticles(burstParticles, dt);
+
+                        icSpawnTimer += dt;
+                        if (!ic.active && !ic.destroyed && icSpawnTimer >= icSpawnInterval) {
+                            icSpawnTimer = 0.0f;
+                            icSpawnInterval = SimRandomFloat(8.0f, 14.0f);
+                            bool valid = false; int tries = 0;
+                            while (!valid && tries < 20) {
+                                float x = playerPos.x + SCREEN_WIDTH + SimRandomValue(350, 1000);
+                                float y = GROUND_Y - icSize.y;
+                                Rectangle icRect = { x, y, icSize.x, icSize.y };
+                                bool overlapsRock = OverlapsAnyActive(rocks, icRect, rockSize, { 0, 0 });
+                                if (!overlapsRock) {
+                                    ic.position = { x, y };
+                                    ic.prevPosition = ic.position;
+                                    ic.active = true;
+                                    ic.destroyed = false;
+                                    ic.destroyTimer = 0;
+                                    valid = true;
+                                }
+                                tries++;
+                            }
+                        }
+
+                        // One kernel per archetype; each applies its hits before the next runs
+                        int icCount = 1, n;
+                        n = StepArchetype<ARCH_IC>(&ic, icCount, archSize[ARCH_IC], archMask[ARCH_IC], player, effectiveSpeed, hits, MAX_TICK_HITS);
+                        for (int i = 0; i < n; i++) applyHit(ARCH_IC, hits[i]);
+                        if (ic.destroyed) {
+                            ic.destroyTimer -= dt;
+                            if (ic.destroyTimer <= 0) {
+                                ic.destroyed = false;
+                            }
+                        }
+                        n = StepArchetype<ARCH_ROCK>(rocks, archSize[ARCH_ROCK], archMask[ARCH_ROCK], player, effectiveSpeed, hits, MAX_TICK_HITS);
+                        for (int i = 0; i < n; i++)
+                            if (applyHit(ARCH_ROCK, hits[i])) goto drawSection;
+                        n = StepArchetype<ARCH_COIN>(coins, archSize[ARCH_COIN], archMask[ARCH_COIN], player, effectiveSpeed, hits, MAX_TICK_HITS);
+                        for (int i = 0; i < n; i++) applyHit(ARCH_COIN, hits[i]);
+                        n = StepArchetype<ARCH_MAGNET>(magnets, archSize[ARCH_MAGNET], archMask[ARCH_MAGNET], player, effectiveSpeed, hits, MAX_TICK_HITS);
+                        for (int i = 0; i < n; i++) applyHit(ARCH_MAGNET, hits[i]);
+                        StepArchetype<ARCH_TREE>(trees, archSize[ARCH_TREE], archMask[ARCH_TREE], player, effectiveSpeed, hits, MAX_TICK_HITS);
+
+                        // Coins are recycled: the ones past the left edge come back ahead of the player
+                        int activeCoinCount = 0;
+                        for (const auto& c : coins) if (c.active) activeCoinCount++;
+                        for (auto& c : coins) {
+                            if (c.position.x < archSize[ARCH_COIN].exitX && activeCoinCount < 20) {
+                                bool validPosition = false; int attempts = 0;
+                                while (!validPosition && attempts < 20) {
+                                    float newX = playerPos.x + SCREEN_WIDTH + SimRandomValue(300, 1000);
+                                    float newY = (float)SimRandomValue(500, 630);
+                                    Rectangle coinArea = { newX, newY, coinSize.x, coinSize.y };
+                                    bool overlapsWithRock = OverlapsAnyActive(rocks, coinArea, rockSize, { 50, 50 });
+                                    bool overlapsWithCoin = OverlapsAnyActive(coins, coinArea, coinSize, { 32, 40 }, &c);
+                                    if (!overlapsWithRock && !overlapsWithCoin) {
+                                        c.position.x = newX; c.position.y = newY;
+                                        c.prevPosition = c.position;
+                                        c.active = true; activeCoinCount++; validPosition = true;
+                                    } else attempts++;
+                                }
+                                if (!validPosition) {
+                                    c.position.x = playerPos.x + SCREEN_WIDTH + SimRandomValue(300, 1000);
+                                    c.position.y = (float)SimRandomValue(500, 630);
+                                    c.prevPosition = c.position;
+                                    c.active = true; activeCoinCount++;
+                                }
+                            }
+                        }
+
+                        // === COIN RUSH ===
+                        if (rushTimer <= 0.0f && coinCount >= nextRushAt) StartCoinRush(RUSH_COINS, playerPos.x);
+                        if (rushTimer > 0.0f) {
+                            rushTimer -= dt;
+                            if (rushTimer > RUSH_TAIL && CoinRushCount() < rushTarget)
+                                CoinRushFill(rushTarget - CoinRushCount(), { SCREEN_WIDTH, 60.0f, 200.0f, GROUND_Y - 100.0f });
+                            RushTickResult rush = CoinRushTick(player.center, RUSH_PULL * dt, effectiveSpeed,
+                                RUSH_PICKUP_RADIUS, -coinSize.x, RUSH_BURST_CELL);
+                            rushBank += rush.picked;
+                            coinCount += rushBank / RUSH_COINS_PER_COIN;
+                            rushBank %= RUSH_COINS_PER_COIN;
+                            // Merged bursts, and only while they stay a small share of the particle pool
+                            for (int i = 0; i < rush.burstCount && (int)burstParticles.size() < RUSH_PARTICLES; i++)
+                                SpawnCoinBurst(burstParticles, rush.bursts[i].at);
+                            if (rushTimer <= 0.0f || CoinRushCount() == 0) EndCoinRush(coinCount);
                         }
-                        it->position.x -= effectiveSpeed;
-                        if (it->position.x < -magnetTexture.width) it = magnets.erase(it); else ++it;
-                    }
-                    for (auto it = rocks.begin(); it != rocks.end();) {
-                        it->position.x -= effectiveSpeed;
-                        if (it->position.x < -rockTexture.width * rockScale) it = rocks.erase(it); else ++it;
-                    }
-                    for (auto it = trees.begin(); it != trees.end();) {
-                        it->position.x -= effectiveSpeed;
-                        if (it->position.x < -treeTexture.width * it->scale) it = trees.erase(it); else ++it;
-                    }
-                }
-                for (auto& s : snowflakes) {
-                    s.y += s.speedY * dt;
-                    s.x += s.driftX * dt * 12.0f; // Stronger drift
-
-                    // Wrap snowflakes to the top when out of screen
-                    if (s.y > SCREEN_HEIGHT) {
-                        s.y = -s.size;
-                        s.x = GetRandomValue(0, SCREEN_WIDTH);
                     }
-                    if (s.x < 0) s.x += SCREEN_WIDTH;
-                    if (s.x > SCREEN_WIDTH) s.x -= SCREEN_WIDTH;
+                    UpdateSnowflakes(snowflakes, QualityWeatherCount((int)snowflakes.size()), dt);
                 }
             }
         }
 
 drawSection:;
+        renderAlpha = simAccumulator / SIM_DT;
+        MetricsFrame(dt);
+        PublishMetrics(currentSpeed);
+        if (currentState == GAME && !isPaused) {
+            TelemetryFrame(dt, (float)PacerFrameBudget());
+            TelemetryEntities((int)coins.size() + CoinRushCount(), (int)birds.size(), (int)rocks.size(),
+                (int)burstParticles.size(), raining ? (int)rainDrops.size() : 0);
+        }
+        idleFrame = idleThrottle && !bankaiActive && !lowManaMsg
+            && (currentState == MENU || currentState == SHOP || currentState == HIGH_SCORE
+                || currentState == ZEN_MODE || (currentState == GAME && isPaused));
+        ProfEnter(PROF_UI);
+        MemSetTag(MEM_TAG_UI);
+        RefreshUiCaches(coinCount, health, mana, coinScale);
         BeginDrawing();
+        ProfEnter(PROF_RECORD);
+        MemSetTag(MEM_TAG_RENDER);
         ClearBackground(BLACK);
+        RenderBegin(SCREEN_WIDTH, SCREEN_HEIGHT);
+        lastCompositorStats = CompositorStats{};
+        lastSpriteStats = SpriteQueueStats{};
 
         if (currentState == GAME) {
-            float offset1 = fmodf(bg1Offset, bg1.width);
-            DrawTexturePro(bg1, { offset1, 0, (float)bg1.width, (float)bg1.height },
-                        { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
-
-            float offset2 = fmodf(bg2Offset, bg2.width);
-            DrawTexturePro(bg2, { offset2, 0, (float)bg2.width, (float)bg2.height },
-                        { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
-            DrawTexturePro(bg2, { offset2 - bg2.width, 0, (float)bg2.width, (float)bg2.height },
-                        { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
+            // Background layers go through the compositor, flushed after the sky tint below
+            CompositorBegin(SCREEN_WIDTH, SCREEN_HEIGHT);
+            float offset1 = fmodf(LerpWrapped(prevBg1Offset, bg1Offset, bg1.width), bg1.width);
+            CompositorLayer(bg1, { offset1, 0, (float)bg1.width, (float)bg1.height },
+                        { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, WHITE);
+
+            if (Quality().parallaxLayers >= 2) {
+                float offset2 = fmodf(LerpWrapped(prevBg2Offset, bg2Offset, bg2.width), bg2.width);
+                CompositorLayer(bg2, { offset2, 0, (float)bg2.width, (float)bg2.height },
+                            { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, WHITE);
+                CompositorLayer(bg2, { offset2 - bg2.width, 0, (float)bg2.width, (float)bg2.height },
+                            { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, WHITE);
+            }
         } else {
-            DrawTexturePro(bg1, { 0, 0, (float)bg1.width, (float)bg1.height },
+            CmdTexturePro(bg1, { 0, 0, (float)bg1.width, (float)bg1.height },
                         { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
         }
 
         if (currentState == MENU) {
-            DrawTexturePro(highScoreIcon, { 0, 0, (float)highScoreIcon.width, (float)highScoreIcon.height },
+            CmdTexturePro(highScoreIcon, { 0, 0, (float)highScoreIcon.width, (float)highScoreIcon.height },
                                           { highScoreRect.x, highScoreRect.y, iconSize, iconSize }, { 0, 0 }, 0, WHITE);
-            DrawText(highScoreText, highScoreRect.x + iconSize + 8, highScoreRect.y + (iconSize - labelFontSize) / 2, labelFontSize, DARKGRAY);
+            CmdTextStatic(highScoreText, highScoreRect.x + iconSize + 8, highScoreRect.y + (iconSize - labelFontSize) / 2, labelFontSize, DARKGRAY);
 
-            int workshopTextWidth = MeasureText(workshopText, labelFontSize);
-            DrawTexturePro(workshopIcon, { 0, 0, (float)workshopIcon.width, (float)workshopIcon.height },
+            int workshopTextWidth = TextWidth(workshopText, labelFontSize);
+            CmdTexturePro(workshopIcon, { 0, 0, (float)workshopIcon.width, (float)workshopIcon.height },
                                            { workshopRect.x, workshopRect.y, iconSize, iconSize }, { 0, 0 }, 0, WHITE);
-            DrawText(workshopText, workshopRect.x - workshopTextWidth - 8, workshopRect.y + (iconSize - labelFontSize) / 2, labelFontSize, DARKGRAY);
+            CmdTextStatic(workshopText, workshopRect.x - workshopTextWidth - 8, workshopRect.y + (iconSize - labelFontSize) / 2, labelFontSize, DARKGRAY);
 
            // Draw the tap-to-start rectangle outline (optional)
-            DrawRectangleLines(tapToStartRect.x, tapToStartRect.y, tapToStartRect.width, tapToStartRect.height, (Color){80, 180, 255, 70});
+            CmdRectangleLines(tapToStartRect.x, tapToStartRect.y, tapToStartRect.width, tapToStartRect.height, (Color){80, 180, 255, 70});
 
             // --- Hover effect: if mouse is over tap area, draw a transparent highlight ---
             if (CheckCollisionPointRec(GetMousePosition(), tapToStartRect)) {
-                DrawRectangleRec(tapToStartRect, (Color){40, 180, 255, 60}); // adjust alpha (60) as you want
+                CmdRectangleRec(tapToStartRect, (Color){40, 180, 255, 60}); // adjust alpha (60) as you want
             }
 
             // Center the text inside the tapToStartRect
-            const char* tapMsg = "tap to start";
-            int tapWidth = MeasureText(tapMsg, tapFontSize);
+            const char* tapMsg = runSuspended ? "tap to resume" : "tap to start";
+            int tapWidth = TextWidth(tapMsg, tapFontSize);
             int tapTextX = tapToStartRect.x + tapToStartRect.width/2 - tapWidth/2;
             int tapTextY = tapToStartRect.y + tapToStartRect.height/2 - tapFontSize/2;
-            DrawText(tapMsg, tapTextX, tapTextY, tapFontSize, (Color){30, 30, 30, tapTextAlpha});
+            CmdTextStatic(tapMsg, tapTextX, tapTextY, tapFontSize, (Color){30, 30, 30, tapTextAlpha});
 
-            DrawTextureEx(standUpFrames[0], playerPos, 0.0f, playerScale, WHITE);
+            CmdTextureEx(standUpFrames[0], playerPos, 0.0f, playerScale, WHITE);
 
 
         }
         else if (currentState == STANDUP) {
-            DrawTextureEx(standUpFrames[standUpCurrentFrame], playerPos, 0.0f, playerScale, WHITE);
+            CmdTextureEx(standUpFrames[standUpCurrentFrame], playerPos, 0.0f, playerScale, WHITE);
         }
 
         // *** SKIN SELECTION SLOT IN SHOP ***
         if (currentState == SHOP) {
-            DrawText(TextFormat("Total Coins: %d", totalCoins), SCREEN_WIDTH / 2 - 180, 150, 32, DARKGRAY);
-
-            int btnW = 480, btnH = 70, gapY = 30;
-            int startX = SCREEN_WIDTH/2 - btnW/2, startY = 240;
-            Rectangle btns[5];
-            for (int i=0;i<5;i++) btns[i] = { (float)startX, (float)(startY + i*(btnH+gapY)), (float)btnW, (float)btnH };
-
-            Color buy = (Color){180, 130, 255, 220};
-            Color buyHover = (Color){200, 160, 255, 240};
-            Color noBuy = (Color){150,150,150,170};
-
-            for (int i = 0; i < 5; i++) {
-                bool hover = CheckCollisionPointRec(GetMousePosition(), btns[i]);
-                DrawRectangleRec(btns[i], hover ? buyHover : buy);
-            }
-            // Health upgrade
-            bool maxedHealth = (maxHealth >= 200);
-            bool canBuyHealth = !maxedHealth && totalCoins >= UPGRADE_COST;
-            if (!canBuyHealth) DrawRectangleRec(btns[0], noBuy);
-            DrawTextureEx(healthTexture, (Vector2){(float)(startX), (float)(startY + 18)}, 0.0f, 0.05f, WHITE);
-            DrawText(TextFormat("Max Health: %d  (+10)", maxHealth), startX +60, startY + 12, 32, PINK);
-            DrawTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 18)}, 0.0f, 0.03f, WHITE);
-            DrawText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 22, 28, DARKGRAY);
-            if (maxedHealth) DrawText("MAX", startX + 415, startY + 12, 28, RED);
-
-            // Mana upgrade
-            bool maxedMana = (maxMana >= 200);
-            bool canBuyMana = !maxedMana && totalCoins >= UPGRADE_COST;
-            if (!canBuyMana) DrawRectangleRec(btns[1], noBuy);
-            DrawTextureEx(manaTexture, (Vector2){(float)(startX), (float)(startY + btnH + gapY + 18)}, 0.0f, 0.11f, WHITE);
-            DrawText(TextFormat("Max Mana: %d  (+10)", maxMana), startX + 60, startY + btnH + gapY + 12, 32, BLACK);
-            DrawTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + btnH + gapY + 18)}, 0.0f, 0.03f, WHITE);
-            DrawText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + btnH + gapY + 22, 28, DARKGRAY);
-            if (maxedMana) DrawText("MAX", startX + 415, startY + btnH + gapY + 12, 28, RED);
-
-            // Bankai Cooldown (with clock icon)
-            float showCd = getBankaiCooldown();
-            bool minCd = (showCd <= BANKAI_COOLDOWN_MIN);
-            bool canBuyCd = !minCd && totalCoins >= UPGRADE_COST;
-            if (!canBuyCd) DrawRectangleRec(btns[2], noBuy);
-            DrawTextureEx(clockTexture, (Vector2){(float)(startX), (float)(startY + 2*(btnH + gapY) + 18)}, 0.0f, 0.04f, WHITE);
-            DrawText(TextFormat("Bankai Cooldown: %.0fs(-5s)", showCd), startX + 60, startY + 2*(btnH + gapY) + 12, 32, BLACK);
-            DrawTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 2*(btnH + gapY) + 18)}, 0.0f, 0.03f, WHITE);
-            DrawText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 2*(btnH + gapY) + 22, 28, DARKGRAY);
-            if (minCd) DrawText("MIN", startX + 420, startY + 2*(btnH + gapY) + 12, 28, RED);
-
-            // Bankai Mana Cost
-            int showCost = getBankaiCost();
-            bool minCost = (showCost <= BANKAI_COST_MIN);
-            bool canBuyCost = !minCost && totalCoins >= UPGRADE_COST;
-            if (!canBuyCost) DrawRectangleRec(btns[3], noBuy);
-            DrawTextureEx(manaTexture, (Vector2){(float)(startX), (float)(startY + 3*(btnH + gapY) + 18)}, 0.0f, 0.11f, WHITE);
-            DrawText(TextFormat("Bankai Cost: %d  (-2)", showCost), startX + 60, startY + 3*(btnH + gapY) + 12, 32, BLACK);
-            DrawTextureEx(coinTexture, (Vector2){(float)(startX + 500), (float)(startY + 3*(btnH + gapY) + 18)}, 0.0f, 0.03f, WHITE);
-            DrawText(TextFormat("%d", UPGRADE_COST), startX + 540, startY + 3*(btnH + gapY) + 22, 28, DARKGRAY);
-            if (minCost) DrawText("MIN", startX + 420, startY + 3*(btnH + gapY) + 12, 28, RED);
-
-            // --- SKIN SELECTION SLOT ---
-            DrawText("Selected Skin:", startX + 60, startY + 4*(btnH+gapY) + 12, 32, DARKBLUE);
-            char skinName[32];
-            if (selectedSkin == 0) strcpy(skinName, "YUSEOL");
-            else if (selectedSkin == 1) strcpy(skinName, "ITACHI");
-            else if (selectedSkin == 2) strcpy(skinName, "GOKU");
-            else strcpy(skinName, "???");
-
-            DrawText(skinName, startX + 300, startY + 4*(btnH+gapY) + 12, 32, (Color){40, 140, 220, 255});
-            // Preview: show first player frame of selected skin
-
-            float previewScale = 0.13f; // You can adjust this
-            DrawTextureEx(skinPreviews[selectedSkin], {(float)(startX+10), (float)(startY + 4*(btnH+gapY) + 8)}, 0.0f, previewScale, WHITE);
-
-            // --- UPGRADE BUYING LOGIC ---
-            if (currentState == SHOP && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                Vector2 mouse = GetMousePosition();
-                if (CheckCollisionPointRec(mouse, btns[0]) && canBuyHealth) {
-                    maxHealth += HEALTH_MANA_STEP;
-                    if (maxHealth > 200) maxHealth = 200;
-                    totalCoins -= UPGRADE_COST;
-                    SaveUpgrades();
-                    SaveStats();
-                }
-                if (CheckCollisionPointRec(mouse, btns[1]) && canBuyMana) {
-                    maxMana += HEALTH_MANA_STEP;
-                    if (maxMana > 200) maxMana = 200;
-                    totalCoins -= UPGRADE_COST;
-                    SaveUpgrades();
-                    SaveStats();
-                }
-                if (CheckCollisionPointRec(mouse, btns[2]) && canBuyCd) {
-                    bankaiCooldownUpgrade++;
-                    totalCoins -= UPGRADE_COST;
-                    SaveUpgrades();
-                    SaveStats();
-                }
-                if (CheckCollisionPointRec(mouse, btns[3]) && canBuyCost) {
-                    bankaiManaCostUpgrade++;
-                    totalCoins -= UPGRADE_COST;
-                    SaveUpgrades();
-                    SaveStats();
-                }
-                if (CheckCollisionPointRec(mouse, btns[4])) {
-                    selectedSkin = (selectedSkin + 1) % NUM_SKINS;
-                    SaveUpgrades();
-                    LoadSkin(selectedSkin);
-                }
-            }
+            UiCacheDraw(shopCache);
         }
 
         if (currentState == GAME) {
-            float offset2 = fmodf(bg2Offset, bg2.width);
-            DrawTexturePro(bg2, { offset2, 0, (float)bg2.width, (float)bg2.height }, { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
-            DrawTexturePro(bg2, { offset2 - bg2.width, 0, (float)bg2.width, (float)bg2.height }, { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
-
-            float timer = std::fmod(dayNightTimer, dayNightDuration);
-            int phaseIndex = (int)(timer / phaseDuration);
-            float t = (timer - phaseIndex * phaseDuration) / phaseDuration;
-            Color skyOverlay = LerpColor(phaseColors[phaseIndex], phaseColors[(phaseIndex + 1) % numPhases], t);
-            DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, skyOverlay);
-
-            for (const auto& s : snowflakes) {
-                DrawCircleV((Vector2){s.x, s.y}, s.size, (Color){255, 255, 255, (unsigned char)(240 * s.opacity)});
+            if (Quality().parallaxLayers >= 2) {
+                float offset2 = fmodf(LerpWrapped(prevBg2Offset, bg2Offset, bg2.width), bg2.width);
+                CompositorLayer(bg2, { offset2, 0, (float)bg2.width, (float)bg2.height }, { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, WHITE);
+                CompositorLayer(bg2, { offset2 - bg2.width, 0, (float)bg2.width, (float)bg2.height }, { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, WHITE);
+            }
+
+            if (Quality().dayNightTint) CompositorOverlay(DayNightColor(dayNightTimer));
+            lastCompositorStats = CompositorFlush();
+
+            int flakeCount = QualityWeatherCount((int)snowflakes.size());
+            for (int i = 0; i < flakeCount; i++) {
+                const SnowFlake& s = snowflakes[i];
+                CmdCircleV(LerpPos({s.prevX, s.prevY}, {s.x, s.y}), s.size, (Color){255, 255, 255, (unsigned char)(240 * s.opacity)});
             }
 
             if (raining) {
-                for (const auto &drop : rainDrops) {
-                    DrawLineEx(
-                        (Vector2){ drop.x, drop.y },
-                        (Vector2){ drop.x, drop.y + drop.length },
+                int dropCount = QualityWeatherCount((int)rainDrops.size());
+                for (int i = 0; i < dropCount; i++) {
+                    const RainDrop& drop = rainDrops[i];
+                    CmdLineEx(
+                        LerpPos({ drop.prevX, drop.prevY }, { drop.x, drop.y }),
+                        LerpPos({ drop.prevX, drop.prevY + drop.length }, { drop.x, drop.y + drop.length }),
                         drop.thickness,
                         (Color){160, 180, 255, (unsigned char)(220 * drop.opacity)}
                     );
@@ -1191,90 +2239,91 @@ drawSection:;
 
             // --- During first 5 seconds, only draw base UI! ---
             if (spawnBlockTimer <= 5.0f) {
-                DrawTextureEx(playerFrames[currentFrame], playerPos, 0.0f, playerScale, WHITE);
-                DrawTextureEx(coinTexture, { 20, 20 }, 0.0f, coinScale, WHITE);
-                DrawText(TextFormat("%d", coinCount), 80, 25, 40, DARKPURPLE);
-                float iconOffsetY = 20 + coinTexture.height * coinScale + 12;
-                DrawTextureEx(healthTexture, { 20, iconOffsetY }, 0.0f, 0.05, WHITE);
-                DrawText(TextFormat("%d", health), 80, (int)iconOffsetY + 5, 40, RED);
-                float manaOffsetY = iconOffsetY + healthTexture.height * coinScale + 12;
-                DrawTextureEx(manaTexture, { 20, manaOffsetY }, 0.0f, 0.1, WHITE);
-                DrawText(TextFormat("%d", mana), 80, (int)manaOffsetY + 5, 40, BLUE);
-
-                DrawTextureEx(isPaused ? resumeIcon : pauseIcon,
+                CmdTextureEx(playerFrames[currentFrame], LerpPos(prevPlayerPos, playerPos), 0.0f, playerScale, WHITE);
+                ResolveWorldPass();
+                UiCacheDraw(hudCache);
+
+                CmdTextureEx(isPaused ? resumeIcon : pauseIcon,
                     {pauseRect.x, pauseRect.y}, 0.0f, (float)iconSize / pauseIcon.width, WHITE);
 
-                DrawTexturePro(
+                CmdTexturePro(
                     isSoundOn ? soundOnTexture : soundOffTexture,
                     {0, 0, (float)soundOnTexture.width, (float)soundOnTexture.height},
                     {soundRect.x, soundRect.y, iconSize, iconSize},
                     {0, 0}, 0, WHITE
                 );
 
-                DrawText(
+                CmdTextStatic(
                 "Sound",
-                soundRect.x - 16 - MeasureText("Sound", labelFontSize),
+                soundRect.x - 16 - TextWidth("Sound", labelFontSize),
                 soundRect.y + (iconSize - labelFontSize)/2,
                 labelFontSize,
                 DARKGRAY
             );
 
-                EndDrawing();
+                EndFrame();
                 continue;
             }
 
             if (!gameIntroActive) {
-                for (const auto& b : birds) if(b.active) DrawTextureEx(birdTexture, b.position, 0.0f, b.scale, WHITE);
-                for (const auto& t : trees) if (t.active) DrawTextureEx(treeTexture, t.position, 0.0f, treeScale, WHITE);
-                for (const auto& c : coins) if (c.active) DrawTextureEx(coinTexture, c.position, 0.0f, coinScale, WHITE);
-                for (const auto& m : magnets) if (m.active) DrawTextureEx(magnetTexture, m.position, 0.0f, magnetScale, WHITE);
-                for (const auto& r : rocks) if (r.active) DrawTextureEx(rockTexture, r.position, 0.0f, rockScale, WHITE);
-                if (ic.active && !ic.destroyed) DrawTextureEx(icTexture, ic.position, 0.0f, icScale, WHITE);
-                else if (ic.destroyed) DrawTextureEx(icDestroyedTexture, ic.position, 0.0f, icScale, WHITE);
+                // Most of these wait off screen to the right; the queue drops them
+                SpriteQueueBegin({ 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT });
+                for (const auto& b : birds) if (b.active) SpriteQueuePush(LAYER_SKY, birdTexture, LerpPos(b.prevPosition, b.position), b.scale, WHITE);
+                for (const auto& t : trees) if (t.active) SpriteQueuePush(LAYER_SCENERY, treeTexture, LerpPos(t.prevPosition, t.position), treeScale, WHITE);
+                for (const auto& r : rocks) if (r.active) SpriteQueuePush(LAYER_OBSTACLES, rockTexture, LerpPos(r.prevPosition, r.position), rockScale, WHITE);
+                if (ic.active && !ic.destroyed) SpriteQueuePush(LAYER_OBSTACLES, icTexture, LerpPos(ic.prevPosition, ic.position), icScale, WHITE);
+                else if (ic.destroyed) SpriteQueuePush(LAYER_OBSTACLES, icDestroyedTexture, LerpPos(ic.prevPosition, ic.position), icScale, WHITE);
+                for (const auto& c : coins) if (c.active) SpriteQueuePush(LAYER_PICKUPS, coinTexture, LerpPos(c.prevPosition, c.position), coinScale, WHITE);
+                for (const auto& m : magnets) if (m.active) SpriteQueuePush(LAYER_PICKUPS, magnetTexture, LerpPos(m.prevPosition, m.position), magnetScale, WHITE);
+                lastSpriteStats = SpriteQueueFlush();
+                // Thousands of one texture, all on screen: one batch command, no queue
+                CoinRushDraw(coinTexture, coinScale * RUSH_COIN_SCALE, renderAlpha);
                 for (const auto& p : burstParticles) {
                     Color c = p.color; float fade = p.life / p.maxLife; c.a = (unsigned char)(255 * fade);
-                    DrawCircleV(p.position, 6, c);
+                    CmdCircleV(LerpPos(p.prevPosition, p.position), 6, c);
                 }
             }
-            DrawTextureEx(onGround ? playerFrames[currentFrame] : jumpFrames[currentFrame], playerPos, 0.0f, playerScale, WHITE);
+            DrawGhosts(playerScale);
+            CmdTextureEx(onGround ? playerFrames[currentFrame] : jumpFrames[currentFrame], LerpPos(prevPlayerPos, playerPos), 0.0f, playerScale, WHITE);
+            ResolveWorldPass();
 
             if (!gameIntroActive) {
-                DrawTextureEx(coinTexture, { 20, 20 }, 0.0f, coinScale, WHITE);
-                DrawText(TextFormat("%d", coinCount), 80, 25, 40, DARKPURPLE);
-                float iconOffsetY = 20 + coinTexture.height * coinScale + 12;
-                DrawTextureEx(healthTexture, { 20, iconOffsetY }, 0.0f, 0.05, WHITE);
-                DrawText(TextFormat("%d", health), 80, (int)iconOffsetY + 5, 40, RED);
-                float manaOffsetY = iconOffsetY + healthTexture.height * coinScale + 12;
-                DrawTextureEx(manaTexture, { 20, manaOffsetY }, 0.0f, 0.1, WHITE);
-                DrawText(TextFormat("%d", mana), 80, (int)manaOffsetY + 5, 40, BLUE);
-
-                if (magnetActive) DrawText(TextFormat("MAGNET: %.1fs", magnetTimer), 20, 180, 30, RED);
-                if (icSlowing) DrawText("Slowed!", SCREEN_WIDTH / 2 - 70, 70, 36, SKYBLUE);
-                DrawTextureEx(isPaused ? resumeIcon : pauseIcon,
+                UiCacheDraw(hudCache);
+
+                if (magnetActive) CmdTextStatic(TextFieldFloat(magnetField, "MAGNET: %.1fs", magnetTimer, 0.1f), 20, 180, 30, RED);
+                if (rushTimer > 0.0f) CmdTextStatic(TextFieldFloat(rushField, "COIN RUSH: %.1fs", rushTimer, 0.1f), 20, 215, 30, GOLD);
+                if (icSlowing) CmdTextStatic("Slowed!", SCREEN_WIDTH / 2 - 70, 70, 36, SKYBLUE);
+                CmdTextureEx(isPaused ? resumeIcon : pauseIcon,
                     {pauseRect.x, pauseRect.y}, 0.0f, (float)iconSize / pauseIcon.width, WHITE);
                 if (bankaiCooldown > 0.0f) {
-                    DrawText(TextFormat("Bankai: %.0fs", ceilf(bankaiCooldown)),
+                    CmdTextStatic(TextFieldInt(bankaiCooldownField, "Bankai: %ds", (int)ceilf(bankaiCooldown)),
                              SCREEN_WIDTH / 2 - 90, SCREEN_HEIGHT - 70, 38, RED);
                 }
                 if (raining)
-                    DrawText("RAIN", SCREEN_WIDTH - 180, 60, 40, (Color){80, 80, 220, 170});
+                    CmdTextStatic("RAIN", SCREEN_WIDTH - 180, 60, 40, (Color){80, 80, 220, 170});
+                if (rewinding) {
+                    CmdTextStatic("<< REWIND", SCREEN_WIDTH / 2 - 110, 120, 44, (Color){255, 255, 255, 220});
+                    CmdRectangle(SCREEN_WIDTH / 2 - 150, 172, 300, 8, (Color){0, 0, 0, 90});
+                    CmdRectangle(SCREEN_WIDTH / 2 - 150, 172, 300 * RewindDepth() / (REWIND_TICKS + 1), 8, (Color){255, 255, 255, 200});
+                }
             }
+            // Over the sprites, the player and the HUD, so it stays its own full-screen pass
             if (bankaiActive && bankaiFlashTimer > 0.0f) {
-                DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(WHITE, 0.80f));
+                CmdRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(WHITE, 0.80f));
             }
             if (bankaiActive && bankaiTextAlpha > 0.0f) {
                 int fontSize = 120;
                 const char* text = "BANKAI";
-                int textW = MeasureText(text, fontSize);
-                DrawText(text, SCREEN_WIDTH/2 - textW/2, SCREEN_HEIGHT/3, fontSize, Fade(RED, bankaiTextAlpha));
+                int textW = TextWidth(text, fontSize);
+                CmdTextLarge(text, SCREEN_WIDTH/2 - textW/2, SCREEN_HEIGHT/3, fontSize, Fade(RED, bankaiTextAlpha));
             }
             if (lowManaMsg) {
                 float alpha = (lowManaMsgTimer / BANKAI_TEXT_FADE);
                 if (alpha > 1.0f) alpha = 1.0f;
                 int warnFont = 56;
                 const char* text = "Low Mana!";
-                int txtW = MeasureText(text, warnFont);
-                DrawText(text, SCREEN_WIDTH/2 - txtW/2, SCREEN_HEIGHT/2 - warnFont/2,
+                int txtW = TextWidth(text, warnFont);
+                CmdTextLarge(text, SCREEN_WIDTH/2 - txtW/2, SCREEN_HEIGHT/2 - warnFont/2,
                     warnFont, (Color){255, 40, 40, (unsigned char)(255*alpha)});
             }
         }
@@ -1305,128 +2354,62 @@ drawSection:;
             float coinIconW = coinTexture.width * coinDisplayScale;
             float coinIconH = coinTexture.height * coinDisplayScale;
             int fontMed = tapFontSize;
-            DrawTextureEx(coinTexture,
+            CmdTextureEx(coinTexture,
                 { centerX - coinIconW / 2 - 40, centerY - 160 }, 0.0f, coinDisplayScale, (Color){255,255,255,210});
-            DrawText(TextFormat("%d", lastRunCoinCount),
+            CmdTextStatic(TextFieldInt(lastRunCoinField, "%d", lastRunCoinCount),
                 (int)(centerX + coinIconW / 2), (int)(centerY - 160 + coinIconH / 2 - fontMed / 2), fontMed, (Color){255,215,0,210});
+            if (lastRunTotal > 0) {
+                const char* rankText = TextFormat("Rank #%lld of %lld runs", lastRunRank, lastRunTotal);
+                CmdText(rankText, (int)centerX - TextWidth(rankText, fontMed) / 2, SCREEN_HEIGHT - 200, fontMed, (Color){255,215,0,210});
+            }
 
             if (waitingNameInput) {
                 const char* congrats = "Congratulations! High Score! Enter your name";
                 int congratsFont = tapFontSize;
-                int congratsWidth = MeasureText(congrats, congratsFont);
+                int congratsWidth = TextWidth(congrats, congratsFont);
                 int congratsY = centerY - 160 + coinIconH + 20;
-                DrawText(congrats, centerX - congratsWidth/2, congratsY, congratsFont, (Color){30,30,30,210});
+                CmdTextStatic(congrats, centerX - congratsWidth/2, congratsY, congratsFont, (Color){30,30,30,210});
                 int inputBoxW = 400, inputBoxH = 48;
                 int inputBoxX = centerX - inputBoxW / 2;
                 int inputBoxY = congratsY + congratsFont + 20;
-                DrawRectangle(inputBoxX, inputBoxY, inputBoxW, inputBoxH, (Color){255,255,255,170});
-                DrawText(nameInput, inputBoxX+16, inputBoxY+8, 32, BLACK);
-                int key = GetCharPressed();
-                while (key > 0) {
-                    int len = strlen(nameInput);
-                    if ((key >= 32) && (key <= 125) && (len < MAX_NAME_LEN)) {
-                        nameInput[len] = (char)key;
-                        nameInput[len+1] = '\0';
-                    }
-                    key = GetCharPressed();
-                }
-                if (IsKeyPressed(KEY_BACKSPACE)) {
-                    int len = strlen(nameInput);
-                    if (len > 0) nameInput[len-1] = '\0';
-                }
-                if (IsKeyPressed(KEY_ENTER) && strlen(nameInput)>0) {
-                    strncpy(highScores[insertIndex].name, nameInput, MAX_NAME_LEN);
-                    SaveHighScores();
-                    waitingNameInput = false;
-                    strcpy(nameInput,"");
-                    currentState = MENU;
-                    playerPos.x = PLAYER_X;
-                    playerPos.y = GROUND_Y - playerHeight;
-                    verticalSpeed = 0;
-                    onGround = true;
-                    standUpCurrentFrame = 0;
-                }
+                CmdRectangle(inputBoxX, inputBoxY, inputBoxW, inputBoxH, (Color){255,255,255,170});
+                CmdTextStatic(nameInput, inputBoxX+16, inputBoxY+8, 32, BLACK);
             } else {
                 const char* retryText = "Tap anywhere to return to Menu";
-                int retryWidth = MeasureText(retryText, tapFontSize);
-                DrawText(retryText, centerX - retryWidth/2, SCREEN_HEIGHT - 140, tapFontSize, LIGHTGRAY);
-                if ((IsMouseButtonPressed(MOUSE_BUTTON_LEFT) || GetKeyPressed() != 0) && !waitingNameInput) {
-                    currentState = MENU;
-                    playerPos.x = PLAYER_X;
-                    playerPos.y = GROUND_Y - playerHeight;
-                    verticalSpeed = 0;
-                    onGround = true;
-                    standUpCurrentFrame = 0;
-                }
+                int retryWidth = TextWidth(retryText, tapFontSize);
+                CmdTextStatic(retryText, centerX - retryWidth/2, SCREEN_HEIGHT - 140, tapFontSize, LIGHTGRAY);
             }
         }
 
         if (currentState == HIGH_SCORE) {
-            DrawText("HIGH SCORE", SCREEN_WIDTH / 2 - 140, 150, 40, RED);
-            DrawText(TextFormat("Best Score: %d", highScore), SCREEN_WIDTH / 2 - 120, 240, 28, BLACK);
-            DrawText("Top 5 Highscores:", SCREEN_WIDTH / 2 - 140, 300, 28, WHITE);
-            for (int i = 0; i < MAX_HIGHSCORES; i++) {
-                DrawText(TextFormat("%d. %-20s %5d", i+1, highScores[i].name, highScores[i].score), SCREEN_WIDTH/2 - 120, 340 + i*38, 28, (i==0?GOLD: (i==1)?(Color){192,192,192,255}: (i==2)?(Color){205,127,50,255}:WHITE));
-            }
+            UiCacheDraw(highScoreCache);
         }
         if (currentState == ZEN_TRANSITION || currentState == ZEN_TRANSITION_BACK || currentState == ZEN_MODE) {
             float t = (currentState == ZEN_TRANSITION) ? transitionX : (currentState == ZEN_TRANSITION_BACK ? transitionX : SCREEN_WIDTH);
             float bg1X = -t, bg2X = SCREEN_WIDTH - t;
             float bg1off = fmodf(bg1Offset, bg1.width);
-            DrawTexturePro(bg1, { bg1off, 0, (float)bg1.width, (float)bg1.height }, { bg1X, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
+            CmdTexturePro(bg1, { bg1off, 0, (float)bg1.width, (float)bg1.height }, { bg1X, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
             float bg2off = fmodf(bg2Offset, bg2.width);
-            DrawTexturePro(bg2, { bg2off, 0, (float)bg2.width, (float)bg2.height }, { bg2X, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
-            if (t > 0) {
-                
-                  // Credits and How to Play - Multi-line Centered              
-                const char* credits[] = {
-                    "Credits",
-                    "A.S.Ayon ",
-                    "Tahsin Mubbassir",
-                    "Tilde Ipson ",
-                    "Nahid",
-                    "",
-                    "How to Play",
-                    "Explore and Enjoy"
-                };
-                int numCredits = sizeof(credits)/sizeof(credits[0]);
-                int baseFont = tapFontSize + 8;
-                int subFont = tapFontSize;
-
-                int y = SCREEN_HEIGHT / 2 - (numCredits * subFont) / 2 - 30;
-
-                for (int i = 0; i < numCredits; i++) {
-                    int font = (i == 0 || i == 5) ? baseFont : subFont;
-                    int width = MeasureText(credits[i], font);
-                    DrawText(
-                        credits[i],
-                        (int)(bg2X + SCREEN_WIDTH / 2 - width / 2),
-                        y,
-                        font,
-                        (Color){ 30, 30, 30, tapTextAlpha }
-                    );
-                    y += font + ((i == 0 || i == 5) ? 16 : 6);
-                }
-
-            }
+            CmdTexturePro(bg2, { bg2off, 0, (float)bg2.width, (float)bg2.height }, { bg2X, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, 0, WHITE);
+            if (t > 0) UiCacheDraw(creditsCache, bg2X);
         }
 
-        DrawTexturePro(
+        CmdTexturePro(
             isSoundOn ? soundOnTexture : soundOffTexture,
             {0, 0, (float)soundOnTexture.width, (float)soundOnTexture.height},
             {soundRect.x, soundRect.y, iconSize, iconSize},
             {0, 0}, 0, WHITE
         );
-        DrawText(
+        CmdTextStatic(
             "Sound",
-            soundRect.x - 16 - MeasureText("Sound", labelFontSize),
+            soundRect.x - 16 - TextWidth("Sound", labelFontSize),
             soundRect.y + (iconSize - labelFontSize)/2,
             labelFontSize,
             DARKGRAY
         );
 
         // Draw Exit Button
-        DrawTextureEx(exitIcon, {exitRect.x, exitRect.y}, 0.0f, (float)iconSize / exitIcon.width, WHITE);
+        CmdTextureEx(exitIcon, {exitRect.x, exitRect.y}, 0.0f, (float)iconSize / exitIcon.width, WHITE);
 
         // Show "Exit to Menu" if in GAME, SHOP, or HIGH_SCORE
         int exitFontSize = labelFontSize; // keep consistent with other icon labels
@@ -1439,29 +2422,24 @@ drawSection:;
         int exitTextX = exitRect.x + iconSize + 16; // 16 px gap to the right of icon
         int exitTextY = exitRect.y + (iconSize - exitFontSize) / 2; // vertical align with icon
 
-        DrawText(exitLabel, exitTextX, exitTextY, exitFontSize, DARKGRAY);
+        CmdTextStatic(exitLabel, exitTextX, exitTextY, exitFontSize, DARKGRAY);
 
 
 
-        // Exit Button Click
-        if (!exitDialogOpen && CheckCollisionPointRec(GetMousePosition(), exitRect) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-            exitDialogOpen = true;
-        }
-
         if (exitDialogOpen) {
             // Dialog background
             int dialogW = 440, dialogH = 200;
             int dialogX = SCREEN_WIDTH / 2 - dialogW / 2;
             int dialogY = SCREEN_HEIGHT / 2 - dialogH / 2;
 
-            DrawRectangle(dialogX, dialogY, dialogW, dialogH, (Color){80, 160, 255, 210});
-            DrawRectangleLines(dialogX, dialogY, dialogW, dialogH, GRAY);
+            CmdRectangle(dialogX, dialogY, dialogW, dialogH, (Color){80, 160, 255, 210});
+            CmdRectangleLines(dialogX, dialogY, dialogW, dialogH, GRAY);
 
             // Confirmation text
             const char* areYouSure = "Sure to Exit?";
             int fontSize = 34;
-            int textW = MeasureText(areYouSure, fontSize);
-            DrawText(areYouSure, dialogX + (dialogW - textW) / 2, dialogY + 36, fontSize, WHITE);
+            int textW = TextWidth(areYouSure, fontSize);
+            CmdTextStatic(areYouSure, dialogX + (dialogW - textW) / 2, dialogY + 36, fontSize, WHITE);
 
             // Yes/No buttons
             int btnW = 120, btnH = 48, btnY = dialogY + 120;
@@ -1471,83 +2449,79 @@ drawSection:;
             Color yesColor = (CheckCollisionPointRec(GetMousePosition(), exitYesBtn) ? SKYBLUE : DARKGRAY);
             Color noColor  = (CheckCollisionPointRec(GetMousePosition(), exitNoBtn) ? PINK : DARKGRAY);
 
-            DrawRectangleRec(exitYesBtn, yesColor);
-            DrawText("Yes", exitYesBtn.x + 32, exitYesBtn.y + 8, 32, WHITE);
-            DrawRectangleRec(exitNoBtn, noColor);
-            DrawText("No",  exitNoBtn.x  + 36, exitNoBtn.y  + 8, 32, WHITE);
+            CmdRectangleRec(exitYesBtn, yesColor);
+            CmdTextStatic("Yes", exitYesBtn.x + 32, exitYesBtn.y + 8, 32, WHITE);
+            CmdRectangleRec(exitNoBtn, noColor);
+            CmdTextStatic("No",  exitNoBtn.x  + 36, exitNoBtn.y  + 8, 32, WHITE);
 
             // Prevent clicking other game elements while dialog is open!
         }
-        EndDrawing();
-
-                if (exitDialogOpen) {
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                Vector2 mouse = GetMousePosition();
-
-                if (CheckCollisionPointRec(mouse, exitYesBtn)) {
-                    if (currentState == GAME || currentState == SHOP || currentState == HIGH_SCORE) {
-                        // Return to menu instead of closing game
-                        if (currentState == GAME && coinCount > 0) {
-                            if (coinCount > highScore) highScore = coinCount;
-                            totalCoins += coinCount;
-                            SaveStats();
-                        }
-                        currentState = MENU;
-                    } else {
-                        // Fully exit game in menu or other states
-                        SaveStats();
-                        SaveSoundState();
-                        SaveHighScores();
-                        SaveUpgrades();
-                        UnloadAssets();
-                        UnloadMusicStream(bgm1);
-                        CloseAudioDevice();
-                        CloseWindow();
-                        exit(0);
-                    }
-                    exitDialogOpen = false;
-                }
-
+        EndFrame();
 
-                if (CheckCollisionPointRec(mouse, exitNoBtn)) {
-                    exitDialogOpen = false; // Close dialog
-                }
-            }
-            if (IsKeyPressed(KEY_ESCAPE)) {
-                exitDialogOpen = false;
-            }
-        }
 
+    }
 
-        // --- High Score Name Insert (if needed) ---
-        if (currentState == GAME_OVER_STATE && !waitingNameInput) {
-            int idx = -1;
-            for (int i = 0; i < MAX_HIGHSCORES; i++) {
-                if (lastRunCoinCount > highScores[i].score) {
-                    idx = i;
-                    break;
-                }
-            }
-            if (idx >= 0) {
-                for (int j = MAX_HIGHSCORES-1; j > idx; j--)
-                    highScores[j] = highScores[j-1];
-                highScores[idx].score = lastRunCoinCount;
-                strcpy(highScores[idx].name, "");
-                insertIndex = idx;
-                waitingNameInput = true;
-                strcpy(nameInput,"");
-            }
+    if (currentState == GAME) {
+        TelemetryEndRun(DEATH_NONE, coinCount, rainPeriodCount);
+        if (savesEnabled) {
+            double startTime = GetTime();
+            SnapBegin(runSnapshot, SNAP_SAVE);
+            TransferRunState(runSnapshot, playerPos, verticalSpeed, currentSpeed, speedTimer,
+                onGround, currentFrame, frameCounter, coinCount,
+                magnetActive, magnetTimer, magnetSpawnTimer, rockSpawnTimer,
+                rockSpawnInterval, treeSpawnTimer, treeSpawnInterval,
+                health, mana, spawnBlockTimer, bankaiActive, bankaiCooldown);
+            WriteRunSnapshot(startTime);
         }
     }
-
+    if (assetDump) AssetsDump(stdout);
+    TelemetryShutdown();
+    MetricsStop();
+    GhostsShutdown();
     SaveStats();
     SaveSoundState();
-    SaveHighScores();
+    ScoreStoreClose();
     SaveUpgrades();
+    UnloadUiCaches();
+    ResScaleUnload();
+    TextSdfUnload();
+    FrameArenaShutdown();
     UnloadAssets();
-    UnloadMusicStream(bgm1);
+    AssetUnloadMusic(bgm1);
 
     CloseAudioDevice();
     CloseWindow();
+
+    if (exportPath) {
+        ExportStats es = ExportEnd();
+        double clip = (double)es.frames / SIM_HZ;
+        printf("exported %d frames (%.1f s of video) to %s in %.1f s, %.1fx realtime\n", es.frames, clip, exportPath,
+            es.wallSeconds, es.wallSeconds > 0.0 ? clip / es.wallSeconds : 0.0);
+        printf("%d encoder threads, render loop waited %.2f s for the encoders", es.threads, es.stallSeconds);
+        if (es.bytes > 0) printf(", %.1f MB written", es.bytes / 1048576.0);
+        printf("\n");
+        return 0;
+    }
+    if (scenario) {
+        // Draw budgets are for normal play; a stress run only reports
+        printf("scenario %s: %s\n", scenario->name, scenario->description);
+        printf("entities: %d coins, %d rush coins, %d birds, %d particles, %d flakes, %d drops\n", (int)coins.size(),
+            CoinRushCount(), (int)birds.size(), (int)burstParticles.size(), (int)snowflakes.size(), (int)rainDrops.size());
+        PrintProfileReport();
+        PrintRenderReport();
+        PrintAssetReport();
+        return 0;
+    }
+    if (maxFrames > 0 || nullRender) {
+        bool ok = PrintRenderReport();
+        if (!PrintAssetReport()) ok = false;
+        if (checkAllocs && steadyAllocs > 0) {
+            printf("check allocs: FAILED\n");
+            ok = false;
+        } else if (checkAllocs) {
+            printf("check allocs: passed\n");
+        }
+        return ok ? 0 : 1;
+    }
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "memtrack.h"
+#include <cstdlib>
+#include <new>
+
+// Per thread: the loader, writer and encoder threads allocate through the same
+// operator new, and neither race with the game thread nor land in its counts
+static thread_local MemTag currentTag = MEM_TAG_OTHER;
+static thread_local MemCounters frameCounters;
+static thread_local MemCounters totals[MEM_TAG_COUNT];
+static const char* tagNames[MEM_TAG_COUNT] = {
+    "other", "assets", "entities", "weather", "particles", "ui", "render"
+};
+
+void MemSetTag(MemTag tag) { currentTag = tag; }
+MemTag MemGetTag() { return currentTag; }
+const char* MemTagName(MemTag tag) { return tagNames[tag]; }
+
+void MemBeginFrame() { frameCounters = MemCounters{}; }
+MemCounters MemFrameCounters() { return frameCounters; }
+MemCounters MemTotalCounters(MemTag tag) { return totals[tag]; }
+
+static void* TrackedAlloc(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    frameCounters.allocs++;
+    frameCounters.bytes += (long long)size;
+    totals[currentTag].allocs++;
+    totals[currentTag].bytes += (long long)size;
+    return p;
+}
+
+void* operator new(size_t size) { return TrackedAlloc(size); }
+void* operator new[](size_t size) { return TrackedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return TrackedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return TrackedAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
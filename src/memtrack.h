@@ -0,0 +1,32 @@
+#pragma once
+
+// ------------ Allocation Tracking --------------
+// Global operator new/delete are replaced to count heap allocations per frame
+// and per system. The system is whatever tag is current when new runs.
+// C allocations (malloc inside raylib, stdio) are not seen. Tag and counters
+// belong to the calling thread, so the game reads only its own allocations.
+enum MemTag {
+    MEM_TAG_OTHER, MEM_TAG_ASSETS, MEM_TAG_ENTITIES, MEM_TAG_WEATHER, MEM_TAG_PARTICLES,
+    MEM_TAG_UI, MEM_TAG_RENDER,
+    MEM_TAG_COUNT
+};
+
+struct MemCounters {
+    long long allocs;
+    long long bytes;
+};
+
+void MemSetTag(MemTag tag);
+MemTag MemGetTag();
+const char* MemTagName(MemTag tag);
+
+void MemBeginFrame();                    // clears the per-frame counters
+MemCounters MemFrameCounters();          // this frame, all tags
+MemCounters MemTotalCounters(MemTag tag); // since start
+
+// Sets a tag for the rest of the scope
+struct MemScope {
+    MemTag saved;
+    explicit MemScope(MemTag tag) : saved(MemGetTag()) { MemSetTag(tag); }
+    ~MemScope() { MemSetTag(saved); }
+};
@@ -0,0 +1,218 @@
+#include "metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET SocketHandle;
+#define CloseSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET (-1)
+#define CloseSocket close
+#endif
+
+#define FRAME_WINDOW 240
+
+// Seqlock: odd sequence = write in progress. The payload lives in relaxed atomic
+// words so the reader's racing copy is well defined; it retries on a torn read.
+#define SNAPSHOT_WORDS ((sizeof(MetricsSnapshot) + 7) / 8)
+static std::atomic<uint32_t> sequence(0);
+static std::atomic<uint64_t> payload[SNAPSHOT_WORDS];
+
+static std::thread server;
+static std::atomic<bool> stopping(false);
+static SocketHandle listener = INVALID_SOCKET;
+
+static float frameTimes[FRAME_WINDOW];
+static int frameCount = 0;
+
+static void WriteSnapshot(const MetricsSnapshot& s) {
+    uint64_t words[SNAPSHOT_WORDS] = {};
+    memcpy(words, &s, sizeof(s));
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < SNAPSHOT_WORDS; i++) payload[i].store(words[i], std::memory_order_relaxed);
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+static void ReadSnapshot(MetricsSnapshot& s) {
+    uint64_t words[SNAPSHOT_WORDS];
+    for (;;) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) { std::this_thread::yield(); continue; }
+        for (size_t i = 0; i < SNAPSHOT_WORDS; i++) words[i] = payload[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    memcpy(&s, words, sizeof(s));
+}
+
+void MetricsFrame(float seconds) {
+    frameTimes[frameCount % FRAME_WINDOW] = seconds * 1000.0f;
+    frameCount++;
+}
+
+void MetricsPublish(MetricsSnapshot& s) {
+    if (!MetricsRunning()) return;
+    int n = std::min(frameCount, FRAME_WINDOW);
+    if (n > 0) {
+        float sorted[FRAME_WINDOW];
+        std::copy(frameTimes, frameTimes + n, sorted);
+        std::sort(sorted, sorted + n);
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) sum += sorted[i];
+        s.fps = sum > 0.0 ? 1000.0 * n / sum : 0.0;
+        s.frameP50 = sorted[(n - 1) * 50 / 100];
+        s.frameP95 = sorted[(n - 1) * 95 / 100];
+        s.frameP99 = sorted[(n - 1) * 99 / 100];
+        s.frameMax = sorted[n - 1];
+    }
+    WriteSnapshot(s);
+}
+
+// ------------ Server --------------
+static int FormatMetrics(char* out, int size) {
+    MetricsSnapshot s;
+    ReadSnapshot(s);
+    int len = snprintf(out, size,
+        "# HELP snowglide_frames_total Frames presented.\n# TYPE snowglide_frames_total counter\n"
+        "snowglide_frames_total %llu\n"
+        "# HELP snowglide_fps Frames per second over the last %d frames.\n# TYPE snowglide_fps gauge\n"
+        "snowglide_fps %.2f\n"
+        "# HELP snowglide_frame_time_ms Frame time over the last %d frames.\n# TYPE snowglide_frame_time_ms summary\n"
+        "snowglide_frame_time_ms{quantile=\"0.5\"} %.3f\n"
+        "snowglide_frame_time_ms{quantile=\"0.95\"} %.3f\n"
+        "snowglide_frame_time_ms{quantile=\"0.99\"} %.3f\n"
+        "snowglide_frame_time_ms{quantile=\"1\"} %.3f\n"
+        "# HELP snowglide_entities Live entities by kind.\n# TYPE snowglide_entities gauge\n"
+        "snowglide_entities{kind=\"coin\"} %d\n"
+        "snowglide_entities{kind=\"magnet\"} %d\n"
+        "snowglide_entities{kind=\"rock\"} %d\n"
+        "snowglide_entities{kind=\"tree\"} %d\n"
+        "snowglide_entities{kind=\"bird\"} %d\n"
+        "snowglide_entities{kind=\"particle\"} %d\n"
+        "snowglide_entities{kind=\"raindrop\"} %d\n"
+        "snowglide_entities{kind=\"snowflake\"} %d\n"
+        "# HELP snowglide_app_state Current screen (1 for the active one).\n# TYPE snowglide_app_state gauge\n"
+        "snowglide_app_state{state=\"%s\",index=\"%d\"} 1\n"
+        "# HELP snowglide_speed Current scroll speed, pixels per tick.\n# TYPE snowglide_speed gauge\n"
+        "snowglide_speed %.3f\n"
+        "# HELP snowglide_frame_allocs Heap allocations in the last frame.\n# TYPE snowglide_frame_allocs gauge\n"
+        "snowglide_frame_allocs %lld\n"
+        "# TYPE snowglide_frame_alloc_bytes gauge\n"
+        "snowglide_frame_alloc_bytes %lld\n"
+        "# HELP snowglide_audio_underruns_total Frames long enough to drain a music buffer half.\n# TYPE snowglide_audio_underruns_total counter\n"
+        "snowglide_audio_underruns_total %llu\n"
+        "# HELP snowglide_quality_level Cosmetic quality level (0 minimal - 3 high).\n# TYPE snowglide_quality_level gauge\n"
+        "snowglide_quality_level %d\n"
+        "# HELP snowglide_res_scale World render scale.\n# TYPE snowglide_res_scale gauge\n"
+        "snowglide_res_scale %.3f\n",
+        (unsigned long long)s.frames, FRAME_WINDOW, s.fps, FRAME_WINDOW, s.frameP50, s.frameP95, s.frameP99, s.frameMax,
+        s.coins, s.magnets, s.rocks, s.trees, s.birds, s.particles, s.rainDrops, s.snowflakes,
+        s.appStateName, s.appState, s.currentSpeed, (long long)s.frameAllocs, (long long)s.frameAllocBytes,
+        (unsigned long long)s.audioUnderruns, s.quality, s.resScale);
+    return std::min(len, size - 1);
+}
+
+static void SendAll(SocketHandle c, const char* data, int len) {
+    while (len > 0) {
+        int sent = (int)send(c, data, len, 0);
+        if (sent <= 0) return;
+        data += sent;
+        len -= sent;
+    }
+}
+
+static void Serve(SocketHandle c) {
+    char request[2048];
+    int got = 0;
+    while (got < (int)sizeof(request) - 1) {
+        int n = (int)recv(c, request + got, sizeof(request) - 1 - got, 0);
+        if (n <= 0) break;
+        got += n;
+        request[got] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    request[got] = '\0';
+    bool found = strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET / ", 6) == 0;
+    static char body[4096];
+    int bodyLen = found ? FormatMetrics(body, sizeof(body)) : snprintf(body, sizeof(body), "not found\n");
+    char header[256];
+    int headerLen = snprintf(header, sizeof(header),
+        "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+        found ? "200 OK" : "404 Not Found", bodyLen);
+    SendAll(c, header, headerLen);
+    SendAll(c, body, bodyLen);
+}
+
+static void ServerLoop() {
+    while (!stopping.load()) {
+        fd_set ready;
+        FD_ZERO(&ready);
+        FD_SET(listener, &ready);
+        timeval wait = { 0, 200 * 1000 }; // wakes up to notice MetricsStop()
+        if (select((int)listener + 1, &ready, nullptr, nullptr, &wait) <= 0) continue;
+        SocketHandle c = accept(listener, nullptr, nullptr);
+        if (c == INVALID_SOCKET) continue;
+#ifdef _WIN32
+        DWORD timeout = 1000;
+#else
+        timeval timeout = { 1, 0 };
+#endif
+        setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+        Serve(c);
+        CloseSocket(c);
+    }
+}
+
+bool MetricsStart(int port) {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == INVALID_SOCKET) return false;
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local scrapers only
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 4) != 0) {
+        CloseSocket(listener);
+        listener = INVALID_SOCKET;
+        return false;
+    }
+    MetricsSnapshot empty;
+    memset(&empty, 0, sizeof(empty));
+    WriteSnapshot(empty);
+    stopping.store(false);
+    server = std::thread(ServerLoop);
+    return true;
+}
+
+void MetricsStop() {
+    if (!server.joinable()) return;
+    stopping.store(true);
+    server.join();
+    CloseSocket(listener);
+    listener = INVALID_SOCKET;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool MetricsRunning() { return server.joinable(); }
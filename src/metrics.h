@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+// ------------ Live Metrics Endpoint --------------
+// Serves the latest snapshot in Prometheus text format on http://127.0.0.1:PORT/metrics.
+// The game thread publishes a snapshot once per frame into a seqlock; the server
+// thread copies it out without ever blocking the game loop. No raylib in here:
+// the Windows socket headers clash with it.
+struct MetricsSnapshot {
+    uint64_t frames;
+    double fps;                               // over the frame-time window
+    float frameP50, frameP95, frameP99, frameMax; // milliseconds, filled by MetricsPublish
+    int32_t coins, magnets, rocks, trees, birds, particles, rainDrops, snowflakes;
+    int32_t appState;
+    char appStateName[24];
+    float currentSpeed;
+    int64_t frameAllocs, frameAllocBytes;     // heap allocations of the last frame
+    uint64_t audioUnderruns;                  // frames that outlasted a music buffer half
+    int32_t quality;
+    float resScale;
+};
+
+bool MetricsStart(int port);     // false when the port cannot be bound
+void MetricsStop();
+bool MetricsRunning();
+void MetricsFrame(float seconds);          // game thread, every frame
+void MetricsPublish(MetricsSnapshot& s);   // game thread: fills the frame-time fields, then publishes
@@ -0,0 +1,111 @@
+#include "pacing.h"
+#include "raylib.h"
+#include "cputime.h"
+#include "inputqueue.h"
+#include <cmath>
+
+#define PRESENT_WINDOW 240
+
+static int targetFps = 60;
+static int displayHz = 60;
+static double frameStart = 0.0;
+static double workTime = 0.0;
+static double lastPresent = 0.0;
+static double intervals[PRESENT_WINDOW];
+static int intervalCount = 0, intervalHead = 0;
+static bool idle = false;
+static int idleFps = 0;
+static double lastCpu = 0.0;
+static CpuUsage cpuUsage = {};
+
+#define IDLE_POLL_SLICE 0.004 // seconds between input polls while idling
+
+void PacerSetTargetFps(int fps) {
+    targetFps = fps;
+    SetTargetFPS(0); // raylib must not wait on its own as well
+}
+int PacerGetTargetFps() { return targetFps; }
+void PacerSetDisplayRate(int hz) { if (hz > 0) displayHz = hz; }
+void PacerSetIdle(bool isIdle, int fps) { idle = isIdle; idleFps = fps; }
+
+// Polls input once; true if anything happened that the next frame must show.
+// The next poll (at the start of the frame) clears pressed edges and the key
+// queues, so the presses are queued right here.
+static bool InputArrived() {
+    PollInputEvents();
+    InputCollect(GetTime());
+    if (WindowShouldClose()) return true;
+    Vector2 d = GetMouseDelta();
+    if (d.x != 0.0f || d.y != 0.0f || GetMouseWheelMove() != 0.0f) return true;
+    for (int b = MOUSE_BUTTON_LEFT; b <= MOUSE_BUTTON_BACK; b++)
+        if (IsMouseButtonPressed(b) || IsMouseButtonReleased(b)) return true;
+    for (int k = KEY_SPACE; k <= KEY_KB_MENU; k++)
+        if (IsKeyPressed(k) || IsKeyReleased(k)) return true;
+    return false;
+}
+
+static void WaitForInput(double seconds) {
+    double until = GetTime() + seconds;
+    for (double left = seconds; left > 0.0; left = until - GetTime()) {
+        WaitTime(left < IDLE_POLL_SLICE ? left : IDLE_POLL_SLICE);
+        if (InputArrived()) break;
+    }
+}
+
+void PacerBeginFrame() {
+    frameStart = GetTime();
+}
+
+void PacerEndWork() {
+    workTime = GetTime() - frameStart;
+}
+
+void PacerEndFrame() {
+    double now = GetTime();
+    int fps = idle ? idleFps : targetFps;
+    if (fps > 0) {
+        double remaining = 1.0 / fps - (now - frameStart);
+        if (remaining > 0.0) {
+            if (idle) WaitForInput(remaining);
+            else WaitTime(remaining);
+            now = GetTime();
+        }
+    }
+    // EndDrawing() has swapped (blocking on vsync if enabled) and any sleep is over:
+    // treat now as this frame's present time
+    double cpu = ProcessCpuSeconds();
+    if (lastPresent > 0.0) {
+        if (idle) {
+            cpuUsage.idleWall += now - lastPresent;
+            cpuUsage.idleCpu += cpu - lastCpu;
+        } else {
+            cpuUsage.activeWall += now - lastPresent;
+            cpuUsage.activeCpu += cpu - lastCpu;
+            intervals[intervalHead] = now - lastPresent;
+            intervalHead = (intervalHead + 1) % PRESENT_WINDOW;
+            if (intervalCount < PRESENT_WINDOW) intervalCount++;
+        }
+    }
+    lastPresent = now;
+    lastCpu = cpu;
+}
+
+double PacerWorkTime() { return workTime; }
+double PacerFrameBudget() { return 1.0 / (targetFps > 0 ? targetFps : displayHz); }
+
+PresentStats PacerPresentStats() {
+    PresentStats st = { intervalCount, 0.0, 0.0, 0.0 };
+    if (intervalCount == 0) return st;
+    double sum = 0.0;
+    for (int i = 0; i < intervalCount; i++) {
+        sum += intervals[i];
+        if (intervals[i] > st.worstInterval) st.worstInterval = intervals[i];
+    }
+    st.meanInterval = sum / intervalCount;
+    double var = 0.0;
+    for (int i = 0; i < intervalCount; i++) var += (intervals[i] - st.meanInterval) * (intervals[i] - st.meanInterval);
+    st.jitter = sqrt(var / intervalCount);
+    return st;
+}
+
+CpuUsage PacerCpuUsage() { return cpuUsage; }
@@ -0,0 +1,32 @@
+#pragma once
+
+// ------------ Frame Pacing --------------
+// Takes over from SetTargetFPS(): measures how long each frame was busy
+// (update and draw, up to the present) and sleeps away the rest of the frame.
+// The present is left out of the busy time: with vsync it waits for the display.
+struct PresentStats {
+    int samples;           // intervals in the window
+    double meanInterval;   // seconds between presents
+    double jitter;         // standard deviation of the interval, seconds
+    double worstInterval;  // longest interval in the window
+};
+
+struct CpuUsage {
+    double activeWall, activeCpu;  // seconds of wall clock and process CPU time in active frames
+    double idleWall, idleCpu;      // the same for idle frames
+};
+
+void PacerSetTargetFps(int fps);   // 0 = uncapped (or left to vsync)
+int PacerGetTargetFps();
+void PacerSetDisplayRate(int hz);  // frame budget used when uncapped
+// Marks the coming frames idle: they are held to idleFps (0 = no cap of its own,
+// e.g. when raylib already waits for events), the wait returning early on input.
+// Idle frames are left out of the present stats and booked apart in the CPU usage.
+void PacerSetIdle(bool idle, int idleFps);
+void PacerBeginFrame();
+void PacerEndWork();               // right before EndDrawing()
+void PacerEndFrame();              // right after EndDrawing()
+double PacerWorkTime();            // busy time of the last frame up to its present, seconds
+double PacerFrameBudget();         // seconds a frame may take at the target rate
+PresentStats PacerPresentStats();  // over the last PRESENT_WINDOW frames
+CpuUsage PacerCpuUsage();          // since start, split by idle and active frames
@@ -0,0 +1,65 @@
+#include "profiler.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstdio>
+
+#define PROF_WINDOW 4096
+
+static const char* phaseNames[PROF_PHASE_COUNT] = { "input", "sim", "ui", "record", "flush", "present" };
+static double frameTimes[PROF_PHASE_COUNT];
+static float samples[PROF_PHASE_COUNT][PROF_WINDOW];
+static double totals[PROF_PHASE_COUNT];
+static long long frames = 0;
+static int current = -1;
+static double phaseStart = 0.0;
+
+void ProfFrameBegin() {
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) frameTimes[i] = 0.0;
+    current = -1;
+}
+
+void ProfEnter(ProfPhase phase) {
+    double now = GetTime();
+    if (current >= 0) frameTimes[current] += now - phaseStart;
+    current = phase;
+    phaseStart = now;
+}
+
+void ProfFrameEnd() {
+    if (current >= 0) frameTimes[current] += GetTime() - phaseStart;
+    current = -1;
+    int slot = (int)(frames % PROF_WINDOW);
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        samples[i][slot] = (float)frameTimes[i];
+        totals[i] += frameTimes[i];
+    }
+    frames++;
+}
+
+void ProfReset() {
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) totals[i] = 0.0;
+    frames = 0;
+}
+
+static float Percentile(float* sorted, int n, float p) {
+    int i = (int)(p * (n - 1) + 0.5f);
+    return sorted[i];
+}
+
+void PrintProfileReport() {
+    if (frames == 0) return;
+    int n = frames < PROF_WINDOW ? (int)frames : PROF_WINDOW;
+    static float sorted[PROF_WINDOW];
+    printf("%-8s %9s %9s %9s %9s   (ms, %lld frames, percentiles over the last %d)\n",
+        "phase", "avg", "p50", "p95", "max", frames, n);
+    double frameAvg = 0.0;
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        std::copy(samples[i], samples[i] + n, sorted);
+        std::sort(sorted, sorted + n);
+        double avg = totals[i] / frames;
+        frameAvg += avg;
+        printf("%-8s %9.3f %9.3f %9.3f %9.3f\n", phaseNames[i], avg * 1000.0,
+            Percentile(sorted, n, 0.50f) * 1000.0, Percentile(sorted, n, 0.95f) * 1000.0, sorted[n - 1] * 1000.0);
+    }
+    printf("%-8s %9.3f\n", "frame", frameAvg * 1000.0);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// ------------ Frame Phase Profiler --------------
+// Splits each frame into sequential phases; ProfEnter() closes the running
+// phase and opens the next. Keeps the last PROF_WINDOW frames for percentiles.
+enum ProfPhase {
+    PROF_INPUT,    // music, input latching
+    PROF_SIM,      // fixed ticks
+    PROF_UI,       // retained panel rebuilds
+    PROF_RECORD,   // recording draw commands
+    PROF_FLUSH,    // replaying them to raylib (or counting them)
+    PROF_PRESENT,  // EndDrawing: buffer swap and event poll
+    PROF_PHASE_COUNT
+};
+
+void ProfFrameBegin();
+void ProfEnter(ProfPhase phase);
+void ProfFrameEnd();
+void ProfReset();
+void PrintProfileReport();   // avg / p50 / p95 / max per phase, milliseconds
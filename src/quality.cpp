@@ -0,0 +1,83 @@
+#include "quality.h"
+#include "raylib.h"
+
+#define QUALITY_WINDOW 120          // frames in the rolling window
+#define QUALITY_DOWN_RATIO 0.95     // step down when the window average is above this share of the budget
+#define QUALITY_UP_RATIO 0.65       // step up only when well below it
+#define QUALITY_UP_DELAY 600        // frames the window must stay cheap before stepping back up
+
+static const QualitySettings levels[QUALITY_LEVEL_COUNT] = {
+    { 0.25f,  6, 1, false },   // QUALITY_MINIMAL
+    { 0.50f, 10, 2, false },   // QUALITY_LOW
+    { 0.75f, 14, 2, true },    // QUALITY_MEDIUM
+    { 1.00f, 20, 2, true },    // QUALITY_HIGH
+};
+static const char* levelNames[QUALITY_LEVEL_COUNT] = { "minimal", "low", "medium", "high" };
+
+static QualityLevel level = QUALITY_HIGH;
+static bool pinned = false;
+static double window[QUALITY_WINDOW];
+static double windowSum = 0.0;
+static int windowCount = 0, windowHead = 0;
+static int cheapFrames = 0;
+
+static void ResetWindow() {
+    windowSum = 0.0;
+    windowCount = windowHead = 0;
+    cheapFrames = 0;
+}
+
+static void SetLevel(QualityLevel next, const char* reason) {
+    if (next == level) return;
+    TraceLog(LOG_INFO, "QUALITY: %s -> %s (%s)", levelNames[level], levelNames[next], reason);
+    level = next;
+    ResetWindow();
+}
+
+void QualityInit(QualityLevel start) {
+    level = start;
+    pinned = false;
+    ResetWindow();
+}
+
+void QualityUpdate(double workTime, double budget) {
+    if (pinned) return;
+    if (windowCount == QUALITY_WINDOW) windowSum -= window[windowHead];
+    else windowCount++;
+    window[windowHead] = workTime;
+    windowSum += workTime;
+    windowHead = (windowHead + 1) % QUALITY_WINDOW;
+    if (windowCount < QUALITY_WINDOW) return;
+
+    double avg = windowSum / QUALITY_WINDOW;
+    if (avg > budget * QUALITY_DOWN_RATIO) {
+        if (level > QUALITY_MINIMAL)
+            SetLevel((QualityLevel)(level - 1), TextFormat("avg %.2f ms over %.2f ms budget", avg * 1000.0, budget * 1000.0));
+    } else if (avg < budget * QUALITY_UP_RATIO) {
+        if (++cheapFrames >= QUALITY_UP_DELAY && level < QUALITY_HIGH)
+            SetLevel((QualityLevel)(level + 1), TextFormat("avg %.2f ms, headroom", avg * 1000.0));
+    } else {
+        cheapFrames = 0;
+    }
+}
+
+void QualityPin(int pinLevel) {
+    if (pinLevel < 0) {
+        if (pinned) TraceLog(LOG_INFO, "QUALITY: unpinned at %s", levelNames[level]);
+        pinned = false;
+        ResetWindow();
+        return;
+    }
+    if (pinLevel >= QUALITY_LEVEL_COUNT) pinLevel = QUALITY_LEVEL_COUNT - 1;
+    SetLevel((QualityLevel)pinLevel, "pinned");
+    pinned = true;
+}
+
+QualityLevel QualityGetLevel() { return level; }
+const QualitySettings& Quality() { return levels[level]; }
+const char* QualityLevelName(QualityLevel l) { return levelNames[l]; }
+
+int QualityWeatherCount(int total) {
+    int n = (int)(total * levels[level].weatherDensity + 0.5f);
+    return n < total ? n : total;
+}
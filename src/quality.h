@@ -0,0 +1,22 @@
+#pragma once
+
+// ------------ Quality Governor --------------
+// Scales cosmetic load (weather, particle bursts, parallax, overlays) in steps
+// to keep frames inside their budget. Gameplay entities are never touched.
+enum QualityLevel { QUALITY_MINIMAL, QUALITY_LOW, QUALITY_MEDIUM, QUALITY_HIGH, QUALITY_LEVEL_COUNT };
+
+struct QualitySettings {
+    float weatherDensity;   // fraction of snowflakes / raindrops simulated and drawn
+    int burstParticles;     // particles per coin burst
+    int parallaxLayers;     // background layers (1 = sky only)
+    bool dayNightTint;      // full-screen day-night tint fill
+};
+
+void QualityInit(QualityLevel start);
+void QualityUpdate(double workTime, double budget);
+void QualityPin(int level);           // fixed level, -1 = follow frame time again
+QualityLevel QualityGetLevel();
+const QualitySettings& Quality();
+const char* QualityLevelName(QualityLevel level);
+// How many of `total` weather particles the current density keeps
+int QualityWeatherCount(int total);
@@ -0,0 +1,196 @@
+#include "render.h"
+#include "arena.h"
+#include "assets.h"
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+// raylib draws shapes with a white texel of the default font atlas, so text and
+// shapes share one batch; they are keyed together when counting texture switches.
+#define FONT_TEXTURE_KEY 0xFFFFFFFFu
+
+struct RenderCmd {
+    RenderCmdType type;
+    Texture2D texture;
+    Rectangle source, dest;     // dest also holds text position / rectangle bounds
+    Vector2 origin, start, end; // start = circle center / line start
+    float rotation, scale;      // scale also holds circle radius / line thickness
+    const char* text;           // in the frame arena
+    int fontSize;
+    const Vector2* positions;   // batch: count positions, owned by the caller
+    int count;
+    Color color;
+};
+
+static RenderBackend backend = RENDER_BACKEND_RAYLIB;
+static std::vector<RenderCmd> cmds;
+static int screenW = 0, screenH = 0;
+static Vector2 targetOrigin = { 0, 0 };
+
+void SetRenderBackend(RenderBackend b) { backend = b; }
+RenderBackend GetRenderBackend() { return backend; }
+
+void RenderBegin(int screenWidth, int screenHeight) {
+    RenderBeginTarget(0, 0, screenWidth, screenHeight);
+}
+
+void RenderBeginTarget(int x, int y, int width, int height) {
+    if (cmds.capacity() == 0) cmds.reserve(4096);
+    cmds.clear();
+    targetOrigin = { (float)x, (float)y };
+    screenW = width;
+    screenH = height;
+}
+
+static RenderCmd& PushCmd(RenderCmdType type, Color color) {
+    cmds.emplace_back();
+    RenderCmd& c = cmds.back();
+    memset(&c, 0, sizeof(c));
+    c.type = type;
+    c.color = color;
+    return c;
+}
+
+void CmdTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    RenderCmd& c = PushCmd(RC_TEXTURE_PRO, tint);
+    c.texture = texture; c.source = source; c.dest = dest; c.origin = origin; c.rotation = rotation;
+}
+void CmdTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) {
+    RenderCmd& c = PushCmd(RC_TEXTURE_EX, tint);
+    c.texture = texture; c.rotation = rotation; c.scale = scale;
+    c.dest = { position.x, position.y, texture.width * scale, texture.height * scale };
+}
+void CmdTextureBatch(Texture2D texture, const Vector2* positions, int count, float scale, Color tint) {
+    if (count <= 0) return;
+    RenderCmd& c = PushCmd(RC_TEXTURE_BATCH, tint);
+    c.texture = texture; c.positions = positions; c.count = count; c.scale = scale;
+    c.dest = { 0, 0, texture.width * scale, texture.height * scale }; // one sprite's size
+}
+void CmdTexturePremultiplied(Texture2D texture, Rectangle source, Rectangle dest) {
+    RenderCmd& c = PushCmd(RC_TEXTURE_PREMUL, WHITE);
+    c.texture = texture; c.source = source; c.dest = dest;
+}
+void CmdTextStatic(const char* text, int posX, int posY, int fontSize, Color color) {
+    RenderCmd& c = PushCmd(RC_TEXT, color);
+    int len = (int)strlen(text);
+    c.text = text;
+    c.fontSize = fontSize;
+    // Approximate extent of the default font (about 0.6 em per glyph), used for stats only
+    c.dest = { (float)posX, (float)posY, len * fontSize * 0.6f, (float)fontSize };
+}
+void CmdText(const char* text, int posX, int posY, int fontSize, Color color) {
+    // TextFormat() hands out rotating static buffers, so the string is copied now
+    char* copy = FrameStrDup(text);
+    if (copy) CmdTextStatic(copy, posX, posY, fontSize, color);
+}
+void CmdCircleV(Vector2 center, float radius, Color color) {
+    RenderCmd& c = PushCmd(RC_CIRCLE, color);
+    c.start = center; c.scale = radius;
+    c.dest = { center.x - radius, center.y - radius, radius * 2, radius * 2 };
+}
+void CmdLineEx(Vector2 startPos, Vector2 endPos, float thick, Color color) {
+    RenderCmd& c = PushCmd(RC_LINE, color);
+    c.start = startPos; c.end = endPos; c.scale = thick;
+    c.dest = { fminf(startPos.x, endPos.x), fminf(startPos.y, endPos.y),
+               fabsf(endPos.x - startPos.x) + thick, fabsf(endPos.y - startPos.y) + thick };
+}
+void CmdRectangle(int posX, int posY, int width, int height, Color color) {
+    RenderCmd& c = PushCmd(RC_RECT, color);
+    c.dest = { (float)posX, (float)posY, (float)width, (float)height };
+}
+void CmdRectangleRec(Rectangle rec, Color color) {
+    RenderCmd& c = PushCmd(RC_RECT, color);
+    c.dest = rec;
+}
+void CmdRectangleLines(int posX, int posY, int width, int height, Color color) {
+    RenderCmd& c = PushCmd(RC_RECT_LINES, color);
+    c.dest = { (float)posX, (float)posY, (float)width, (float)height };
+}
+
+static unsigned int TextureKey(const RenderCmd& c) {
+    return (c.type == RC_TEXTURE_PRO || c.type == RC_TEXTURE_EX || c.type == RC_TEXTURE_PREMUL || c.type == RC_TEXTURE_BATCH)
+        ? c.texture.id : FONT_TEXTURE_KEY;
+}
+
+// Pixels a command touches on screen (rotation is ignored, none of our draws rotate)
+static double CoveredPixels(const RenderCmd& c) {
+    if (c.type == RC_TEXTURE_BATCH) {
+        RenderCmd one = c;
+        one.type = RC_TEXTURE_EX;
+        double sum = 0.0;
+        for (int i = 0; i < c.count; i++) {
+            one.dest.x = c.positions[i].x; one.dest.y = c.positions[i].y;
+            sum += CoveredPixels(one);
+        }
+        return sum;
+    }
+    float dx = c.dest.x - targetOrigin.x, dy = c.dest.y - targetOrigin.y;
+    float x0 = fmaxf(dx, 0.0f), y0 = fmaxf(dy, 0.0f);
+    float x1 = fminf(dx + c.dest.width, (float)screenW);
+    float y1 = fminf(dy + c.dest.height, (float)screenH);
+    if (x1 <= x0 || y1 <= y0) return 0.0;
+    double box = (double)(x1 - x0) * (y1 - y0);
+    switch (c.type) {
+        case RC_CIRCLE: return box * (PI / 4.0);
+        case RC_LINE: {
+            float len = sqrtf((c.end.x - c.start.x) * (c.end.x - c.start.x) + (c.end.y - c.start.y) * (c.end.y - c.start.y));
+            return fmin(box, (double)len * c.scale);
+        }
+        case RC_RECT_LINES: return fmin(box, 2.0 * ((x1 - x0) + (y1 - y0)));
+        default: return box;
+    }
+}
+
+static void Replay(const RenderCmd& cmd) {
+    RenderCmd c = cmd;
+    c.dest.x -= targetOrigin.x; c.dest.y -= targetOrigin.y;
+    c.start.x -= targetOrigin.x; c.start.y -= targetOrigin.y;
+    c.end.x -= targetOrigin.x; c.end.y -= targetOrigin.y;
+    switch (c.type) {
+        case RC_TEXTURE_PRO: DrawTexturePro(c.texture, c.source, c.dest, c.origin, c.rotation, c.color); break;
+        case RC_TEXTURE_EX: DrawTextureEx(c.texture, { c.dest.x, c.dest.y }, c.rotation, c.scale, c.color); break;
+        case RC_TEXTURE_PREMUL:
+            BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+            DrawTexturePro(c.texture, c.source, c.dest, { 0, 0 }, 0.0f, WHITE);
+            EndBlendMode();
+            break;
+        case RC_TEXTURE_BATCH:
+            for (int i = 0; i < c.count; i++)
+                DrawTextureEx(c.texture, { c.positions[i].x - targetOrigin.x, c.positions[i].y - targetOrigin.y }, 0.0f, c.scale, c.color);
+            break;
+        case RC_TEXT: DrawText(c.text, (int)c.dest.x, (int)c.dest.y, c.fontSize, c.color); break;
+        case RC_CIRCLE: DrawCircleV(c.start, c.scale, c.color); break;
+        case RC_LINE: DrawLineEx(c.start, c.end, c.scale, c.color); break;
+        case RC_RECT: DrawRectangleRec(c.dest, c.color); break;
+        case RC_RECT_LINES: DrawRectangleLines((int)c.dest.x, (int)c.dest.y, (int)c.dest.width, (int)c.dest.height, c.color); break;
+        default: break;
+    }
+}
+
+RenderStats RenderFlush() {
+    RenderStats stats;
+    memset(&stats, 0, sizeof(stats));
+    unsigned int lastKey = 0;
+    for (size_t i = 0; i < cmds.size(); i++) {
+        const RenderCmd& c = cmds[i];
+        unsigned int key = TextureKey(c);
+        if (i > 0 && key != lastKey) stats.textureSwitches++;
+        lastKey = key;
+        if (key != FONT_TEXTURE_KEY) AssetTouchTexture(key, c.dest.width, c.dest.height);
+        stats.drawCalls++;
+        stats.primitives[c.type]++;
+        stats.coveredPixels += CoveredPixels(c);
+        if (backend == RENDER_BACKEND_RAYLIB) Replay(c);
+    }
+    if (screenW > 0 && screenH > 0) stats.overdraw = (float)(stats.coveredPixels / ((double)screenW * screenH));
+    cmds.clear();
+    return stats;
+}
+
+void AddRenderStats(RenderStats& total, const RenderStats& part) {
+    total.drawCalls += part.drawCalls;
+    total.textureSwitches += part.textureSwitches;
+    for (int i = 0; i < RC_TYPE_COUNT; i++) total.primitives[i] += part.primitives[i];
+    total.coveredPixels += part.coveredPixels;
+    if (screenW > 0 && screenH > 0) total.overdraw = (float)(total.coveredPixels / ((double)screenW * screenH));
+}
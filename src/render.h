@@ -0,0 +1,46 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Render Command Buffer --------------
+// Every draw of a frame is recorded here and replayed (or only counted) by the
+// active backend at RenderFlush(). The Cmd* functions mirror the raylib calls.
+enum RenderBackend { RENDER_BACKEND_RAYLIB, RENDER_BACKEND_NULL };
+
+enum RenderCmdType {
+    RC_TEXTURE_PRO, RC_TEXTURE_EX, RC_TEXTURE_PREMUL, RC_TEXT, RC_CIRCLE, RC_LINE, RC_RECT, RC_RECT_LINES,
+    RC_TEXTURE_BATCH, RC_TYPE_COUNT
+};
+
+struct RenderStats {
+    int drawCalls;                  // recorded draw commands
+    int textureSwitches;            // texture changes between consecutive commands (batch breaks)
+    int primitives[RC_TYPE_COUNT];  // commands per type
+    double coveredPixels;           // summed on-screen area of every command
+    float overdraw;                 // coveredPixels / screen pixels
+};
+
+void SetRenderBackend(RenderBackend backend);
+RenderBackend GetRenderBackend();
+
+void RenderBegin(int screenWidth, int screenHeight);
+// Records in screen coordinates but replays relative to (x, y) into a width x height target
+void RenderBeginTarget(int x, int y, int width, int height);
+RenderStats RenderFlush();
+// Adds the counts of one flush into another (frames drawn in several passes)
+void AddRenderStats(RenderStats& total, const RenderStats& part);
+
+void CmdTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void CmdTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint);
+// One texture at many positions, unrotated: a single command (raylib batches the
+// quads into one draw). No copy: positions must stay unchanged until the flush.
+void CmdTextureBatch(Texture2D texture, const Vector2* positions, int count, float scale, Color tint);
+// Draws a texture holding premultiplied alpha (e.g. a cached UI panel)
+void CmdTexturePremultiplied(Texture2D texture, Rectangle source, Rectangle dest);
+void CmdText(const char* text, int posX, int posY, int fontSize, Color color);
+// No copy: text must stay unchanged until the flush (literals, TextField buffers)
+void CmdTextStatic(const char* text, int posX, int posY, int fontSize, Color color);
+void CmdCircleV(Vector2 center, float radius, Color color);
+void CmdLineEx(Vector2 startPos, Vector2 endPos, float thick, Color color);
+void CmdRectangle(int posX, int posY, int width, int height, Color color);
+void CmdRectangleRec(Rectangle rec, Color color);
+void CmdRectangleLines(int posX, int posY, int width, int height, Color color);
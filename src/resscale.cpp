@@ -0,0 +1,126 @@
+#include "resscale.h"
+#include "assets.h"
+#include <cmath>
+
+#define SCALE_STEP 0.1f
+#define GROW_AFTER_FRAMES 90     // this many cheap frames in a row before growing again
+#define SHRINK_LOAD 0.90         // share of the budget that counts as too slow
+#define GROW_LOAD 0.60           // share of the budget that leaves room to grow
+
+static bool enabled = false;
+static int screenW = 0, screenH = 0;
+static float minScale = 1.0f, maxScale = 1.0f, scale = 1.0f, pinned = 0.0f;
+static RenderTexture2D target;
+static Shader sharpenShader;
+static int texelSizeLoc = -1, amountLoc = -1;
+static bool sharpen = false;
+static double smoothedWork = 0.0;
+static int cheapFrames = 0;
+
+static const char* sharpenFs =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "uniform vec2 texelSize;\n"
+    "uniform float amount;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    vec3 c = texture(texture0, fragTexCoord).rgb;\n"
+    "    vec3 n = texture(texture0, fragTexCoord + vec2(texelSize.x, 0.0)).rgb\n"
+    "           + texture(texture0, fragTexCoord - vec2(texelSize.x, 0.0)).rgb\n"
+    "           + texture(texture0, fragTexCoord + vec2(0.0, texelSize.y)).rgb\n"
+    "           + texture(texture0, fragTexCoord - vec2(0.0, texelSize.y)).rgb;\n"
+    "    vec3 s = clamp(c + (4.0 * c - n) * amount, 0.0, 1.0);\n"
+    "    finalColor = vec4(s, 1.0) * colDiffuse * fragColor;\n"
+    "}\n";
+
+void ResScaleInit(int screenWidth, int screenHeight, float minS, float maxS) {
+    screenW = screenWidth;
+    screenH = screenHeight;
+    minScale = minS;
+    maxScale = maxS;
+    scale = 1.0f;
+    // Sized for the largest scale once, smaller scales use its top-left corner
+    target = LoadRenderTexture((int)ceilf(screenW * maxScale), (int)ceilf(screenH * maxScale));
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    AssetTrackRenderTexture(target, "world target", "render");
+    sharpenShader = LoadShaderFromMemory(0, sharpenFs);
+    texelSizeLoc = GetShaderLocation(sharpenShader, "texelSize");
+    amountLoc = GetShaderLocation(sharpenShader, "amount");
+    enabled = target.id != 0;
+}
+
+void ResScaleUnload() {
+    if (!enabled) return;
+    AssetUntrack(target.texture);
+    UnloadRenderTexture(target);
+    UnloadShader(sharpenShader);
+    enabled = false;
+}
+
+bool ResScaleEnabled() { return enabled; }
+float ResScaleGetScale() { return scale; }
+void ResScaleSetSharpen(bool on) { sharpen = on; }
+bool ResScaleGetSharpen() { return sharpen; }
+
+void ResScalePin(float s) {
+    pinned = s;
+    if (s > 0.0f) scale = fminf(fmaxf(s, minScale), maxScale);
+}
+
+void ResScaleUpdate(double workTime, double budget) {
+    smoothedWork = smoothedWork * 0.9 + workTime * 0.1;
+    if (pinned > 0.0f) return;
+    if (smoothedWork > budget * SHRINK_LOAD && scale > minScale) {
+        scale = fmaxf(scale - SCALE_STEP, minScale);
+        smoothedWork = budget * GROW_LOAD; // give the new size a moment to show its cost
+        cheapFrames = 0;
+    } else if (smoothedWork < budget * GROW_LOAD) {
+        if (++cheapFrames >= GROW_AFTER_FRAMES && scale < maxScale) {
+            scale = fminf(scale + SCALE_STEP, maxScale);
+            cheapFrames = 0;
+        }
+    } else {
+        cheapFrames = 0;
+    }
+}
+
+RenderStats ResScaleFlushWorld() {
+    // At native size the target would only be copied 1:1, so the world goes straight
+    // to the backbuffer. Sharpening only applies below native, so it never needs the target here.
+    if (fabsf(scale - 1.0f) < SCALE_STEP * 0.01f) {
+        RenderStats stats = RenderFlush();
+        RenderBegin(screenW, screenH);
+        return stats;
+    }
+    int w = (int)(screenW * scale), h = (int)(screenH * scale);
+    BeginTextureMode(target);
+    ClearBackground(BLACK);
+    Camera2D cam = { { 0, 0 }, { 0, 0 }, 0.0f, (float)w / screenW };
+    BeginMode2D(cam);
+    RenderStats stats = RenderFlush();
+    EndMode2D();
+    EndTextureMode();
+
+    // Render textures are stored upside down: the drawn corner is the top rows
+    float th = (float)target.texture.height;
+    Rectangle src = { 0, th - h, (float)w, -(float)h };
+    bool useSharpen = sharpen && scale < 1.0f;
+    if (useSharpen) {
+        float texel[2] = { 1.0f / target.texture.width, 1.0f / target.texture.height };
+        float amount = 0.25f;
+        SetShaderValue(sharpenShader, texelSizeLoc, texel, SHADER_UNIFORM_VEC2);
+        SetShaderValue(sharpenShader, amountLoc, &amount, SHADER_UNIFORM_FLOAT);
+        BeginShaderMode(sharpenShader);
+    }
+    DrawTexturePro(target.texture, src, { 0, 0, (float)screenW, (float)screenH }, { 0, 0 }, 0.0f, WHITE);
+    if (useSharpen) EndShaderMode();
+    stats.drawCalls++;
+    stats.primitives[RC_TEXTURE_PRO]++;
+    stats.coveredPixels += (double)screenW * screenH;
+
+    RenderBegin(screenW, screenH);
+    return stats;
+}
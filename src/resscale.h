@@ -0,0 +1,19 @@
+#pragma once
+#include "raylib.h"
+#include "render.h"
+
+// ------------ Dynamic Resolution --------------
+// The game world is drawn into an offscreen target whose size follows the frame
+// time, then stretched (optionally sharpened) onto the window. The HUD is drawn
+// afterwards at native resolution.
+void ResScaleInit(int screenWidth, int screenHeight, float minScale, float maxScale);
+void ResScaleUnload();
+bool ResScaleEnabled();
+void ResScaleUpdate(double workTime, double budget);
+void ResScalePin(float scale);     // fixed scale, 0 = follow frame time again
+float ResScaleGetScale();
+void ResScaleSetSharpen(bool enabled);
+bool ResScaleGetSharpen();
+// Replays what was recorded so far into the target and blits it to the screen
+// (at scale 1 straight onto the screen), then starts a fresh command buffer for the HUD
+RenderStats ResScaleFlushWorld();
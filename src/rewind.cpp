@@ -0,0 +1,123 @@
+#include "rewind.h"
+#include <cstdint>
+#include <cstring>
+
+struct RewindRecord { uint32_t offset, length; };
+
+static uint8_t ring[REWIND_RING_BYTES];
+static RewindRecord records[REWIND_TICKS];
+static int oldest = 0, count = 0;
+static uint32_t head = 0;                  // where the next record is written
+static uint8_t newest[REWIND_MAX_STATE];   // the last pushed state, in full
+static uint8_t scratch[REWIND_MAX_STATE * 2];
+static size_t stateSize = 0;
+
+void RewindReset() {
+    oldest = count = 0;
+    head = 0;
+    stateSize = 0;
+}
+
+static uint8_t* PutVarint(uint8_t* out, uint32_t v) {
+    while (v >= 0x80) { *out++ = (uint8_t)(v | 0x80); v >>= 7; }
+    *out++ = (uint8_t)v;
+    return out;
+}
+static const uint8_t* GetVarint(const uint8_t* in, uint32_t& v) {
+    v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *in++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return in;
+    }
+}
+
+// a XOR b as (zero run, literal run, literal bytes) triples; returns the encoded size
+static size_t EncodeDelta(const uint8_t* a, const uint8_t* b, size_t size, uint8_t* out) {
+    uint8_t* p = out;
+    size_t i = 0;
+    while (i < size) {
+        size_t zeros = i;
+        while (i < size && a[i] == b[i]) i++;
+        size_t lit = i;
+        // a literal run ends at the first pair of equal bytes (a lone one is cheaper kept)
+        while (i < size && !(a[i] == b[i] && (i + 1 == size || a[i + 1] == b[i + 1]))) i++;
+        if (lit == i) break; // only zeros remain
+        p = PutVarint(p, (uint32_t)(lit - zeros));
+        p = PutVarint(p, (uint32_t)(i - lit));
+        for (size_t k = lit; k < i; k++) *p++ = a[k] ^ b[k];
+    }
+    return (size_t)(p - out);
+}
+
+static void ApplyDelta(uint8_t* state, const uint8_t* delta, size_t length) {
+    const uint8_t* p = delta;
+    const uint8_t* end = delta + length;
+    size_t at = 0;
+    while (p < end) {
+        uint32_t zeros, lit;
+        p = GetVarint(p, zeros);
+        p = GetVarint(p, lit);
+        at += zeros;
+        for (uint32_t k = 0; k < lit; k++) state[at++] ^= *p++;
+    }
+}
+
+static void DropOldest() {
+    oldest = (oldest + 1) % REWIND_TICKS;
+    count--;
+}
+
+// True if the oldest record overlaps [start, start + length) of the ring
+static bool OldestOverlaps(uint32_t start, uint32_t length) {
+    if (count == 0) return false;
+    const RewindRecord& r = records[oldest];
+    return r.offset < start + length && start < r.offset + r.length;
+}
+
+void RewindPush(const void* state, size_t size) {
+    if (size > REWIND_MAX_STATE) return;
+    if (size != stateSize) { // first state of a history
+        RewindReset();
+        stateSize = size;
+        memcpy(newest, state, size);
+        return;
+    }
+    uint32_t length = (uint32_t)EncodeDelta((const uint8_t*)state, newest, size, scratch);
+    if (length > REWIND_RING_BYTES / 4) { // cannot be kept: history restarts here
+        RewindReset();
+        stateSize = size;
+        memcpy(newest, state, size);
+        return;
+    }
+    if (head + length > REWIND_RING_BYTES) {
+        while (count > 0 && records[oldest].offset >= head) DropOldest(); // the tail we skip
+        head = 0;
+    }
+    while (OldestOverlaps(head, length)) DropOldest();
+    if (count == REWIND_TICKS) DropOldest();
+    memcpy(ring + head, scratch, length);
+    records[(oldest + count) % REWIND_TICKS] = { head, length };
+    count++;
+    head += length;
+    memcpy(newest, state, size);
+}
+
+bool RewindStep(void* state, size_t size) {
+    if (stateSize == 0 || size != stateSize) return false;
+    memcpy(state, newest, size);
+    if (count == 0) { stateSize = 0; return true; } // that was the oldest state
+    const RewindRecord& r = records[(oldest + count - 1) % REWIND_TICKS];
+    ApplyDelta(newest, ring + r.offset, r.length);
+    head = r.offset; // the ring is a stack at its newest end
+    count--;
+    return true;
+}
+
+int RewindDepth() { return stateSize ? count + 1 : 0; }
+
+size_t RewindBytes() {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) total += records[(oldest + i) % REWIND_TICKS].length;
+    return total;
+}
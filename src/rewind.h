@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+// ------------ Rewind History --------------
+// Keeps the last REWIND_SECONDS of a fixed-size POD state as per-tick deltas:
+// each tick is XORed against the one before and the zero runs squeezed out.
+// Only the newest state is held in full; stepping back XORs the newest delta
+// into it, so the history is walked backwards and needs no keyframes. The
+// deltas live in a fixed byte ring; when it fills, the oldest ticks go.
+#define REWIND_SECONDS 5
+#define REWIND_TICKS (REWIND_SECONDS * 60)
+#define REWIND_MAX_STATE (8 * 1024)
+#define REWIND_RING_BYTES (REWIND_SECONDS * 48 * 1024)
+
+void RewindReset();
+void RewindPush(const void* state, size_t size);  // the state a tick starts from
+bool RewindStep(void* state, size_t size);        // pops the newest state into state; false when empty
+int RewindDepth();                                // ticks available
+size_t RewindBytes();                             // ring bytes in use
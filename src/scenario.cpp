@@ -0,0 +1,24 @@
+#include "scenario.h"
+#include <cstdio>
+#include <cstring>
+
+static const Scenario scenarios[] = {
+    { "baseline",     "normal play, kept alive",             0,     0,     0,    0, false, false,  1.0f, 0 },
+    { "coins10k",     "10k coins with the magnet always on", 10000, 0,     0,    0, true,  false,  1.0f, 0 },
+    { "birds2k",      "2k birds in flight",                  0,     2000,  0,    0, false, false,  1.0f, 0 },
+    { "storm",        "heaviest rain plus a 5k-flake blizzard", 0,  0,     0, 5000, false, true,   1.0f, 0 },
+    { "particles50k", "50k burst particles alive",           0,     0, 50000,    0, false, false,  1.0f, 0 },
+    { "rush5k",       "5k-coin rush under the magnet",       0,     0,     0,    0, false, false,  1.0f, 5000 },
+    { "speed10",      "scroll speed x10",                    0,     0,     0,    0, false, false, 10.0f, 0 },
+};
+
+const Scenario* FindScenario(const char* name) {
+    for (const Scenario& s : scenarios)
+        if (strcmp(s.name, name) == 0) return &s;
+    return nullptr;
+}
+
+void PrintScenarios() {
+    printf("scenarios:\n");
+    for (const Scenario& s : scenarios) printf("  %-14s %s\n", s.name, s.description);
+}
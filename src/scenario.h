@@ -0,0 +1,20 @@
+#pragma once
+
+// ------------ Scenario Presets --------------
+// Named stress loads for scaling measurements (--scenario NAME). The game keeps
+// the load in place every tick and prints a per-phase timing report at exit.
+struct Scenario {
+    const char* name;
+    const char* description;
+    int coins;            // coin set size, 0 = the normal 10
+    int birds;            // birds kept on their way in, 0 = normal spawning
+    int particles;        // burst particles kept alive, 0 = only real pickups
+    int snowflakes;       // 0 = the normal count
+    bool magnetAlways;
+    bool rainAlways;      // heaviest rain, restarted whenever it stops
+    float speedScale;     // multiplies the scroll speed
+    int rushCoins;        // coin rush kept on with this many coins, 0 = normal rushes
+};
+
+const Scenario* FindScenario(const char* name);
+void PrintScenarios();
@@ -0,0 +1,214 @@
+#include "scorestore.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SCORE_MAGIC 0x53524353u  // "SCRS"
+#define SCORE_VERSION 1
+#define GROW_RECORDS (64 * 1024) // file grows 2 MB at a time
+
+struct ScoreFileHeader {
+    uint32_t magic, version;
+    uint64_t count;
+    uint32_t recordSize, reserved[3];
+};
+static_assert(sizeof(ScoreFileHeader) == 32 && sizeof(ScoreRecord) == 32, "score file layout changed, bump SCORE_VERSION");
+
+static unsigned char* mapped = nullptr;
+static uint64_t mappedBytes = 0;
+#ifdef _WIN32
+static HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#else
+static int file = -1;
+#endif
+
+static std::vector<uint32_t> fenwick(1, 0); // 1-based over score values 0..size-1
+static uint64_t fenwickTotal = 0;
+static std::vector<long long> top;          // record indices of the best runs
+
+static ScoreFileHeader* Header() { return (ScoreFileHeader*)mapped; }
+static ScoreRecord* Records() { return (ScoreRecord*)(mapped + sizeof(ScoreFileHeader)); }
+static uint64_t Capacity() { return (mappedBytes - sizeof(ScoreFileHeader)) / sizeof(ScoreRecord); }
+
+// ------------ Mapping --------------
+static void Unmap() {
+    if (!mapped) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapped);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    munmap(mapped, mappedBytes);
+#endif
+    mapped = nullptr;
+}
+
+// Maps the file at the given size, extending it if it is shorter
+static bool Map(uint64_t bytes) {
+#ifdef _WIN32
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(bytes >> 32), (DWORD)bytes, nullptr);
+    if (!mapping) return false;
+    mapped = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)bytes);
+    if (!mapped) { CloseHandle(mapping); mapping = nullptr; return false; }
+#else
+    struct stat st;
+    if (fstat(file, &st) != 0) return false;
+    if ((uint64_t)st.st_size < bytes && ftruncate(file, (off_t)bytes) != 0) return false;
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (p == MAP_FAILED) return false;
+    mapped = (unsigned char*)p;
+#endif
+    mappedBytes = bytes;
+    return true;
+}
+
+static uint64_t FileBytes() {
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    return GetFileSizeEx(file, &size) ? (uint64_t)size.QuadPart : 0;
+#else
+    struct stat st;
+    return fstat(file, &st) == 0 ? (uint64_t)st.st_size : 0;
+#endif
+}
+
+static uint64_t BytesFor(uint64_t records) {
+    uint64_t chunks = (records + GROW_RECORDS - 1) / GROW_RECORDS;
+    return sizeof(ScoreFileHeader) + std::max<uint64_t>(chunks, 1) * GROW_RECORDS * sizeof(ScoreRecord);
+}
+
+// ------------ Rank Index --------------
+static uint32_t FenwickIndex(int score) { return (uint32_t)std::max(score, 0) + 1; }
+
+static void FenwickAdd(int score) {
+    uint32_t i = FenwickIndex(score);
+    // Doubling only adds nodes covering empty ranges, except the new root
+    while (i >= fenwick.size()) {
+        size_t n = fenwick.size() - 1;
+        size_t grown = n == 0 ? 1024 : n * 2;
+        fenwick.resize(grown + 1, 0);
+        fenwick[grown] = (uint32_t)fenwickTotal;
+    }
+    for (; i < fenwick.size(); i += i & (0u - i)) fenwick[i]++;
+    fenwickTotal++;
+}
+
+// Runs scoring score or less
+static uint64_t FenwickPrefix(int score) {
+    if (score < 0) return 0;
+    uint64_t sum = 0;
+    for (uint64_t i = std::min<uint64_t>(FenwickIndex(score), fenwick.size() - 1); i > 0; i -= i & (0 - i)) sum += fenwick[i];
+    return sum;
+}
+
+static bool Better(long long a, long long b) {
+    const ScoreRecord* r = Records();
+    return r[a].score != r[b].score ? r[a].score > r[b].score : a < b;
+}
+
+static void TopInsert(long long index) {
+    if ((int)top.size() == SCORE_TOP_MAX && !Better(index, top.back())) return;
+    top.insert(std::upper_bound(top.begin(), top.end(), index, Better), index);
+    if ((int)top.size() > SCORE_TOP_MAX) top.pop_back();
+}
+
+// ------------ Store --------------
+bool ScoreStoreOpen(const char* path) {
+    ScoreStoreClose();
+#ifdef _WIN32
+    file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+#else
+    file = open(path, O_RDWR | O_CREAT, 0644);
+    if (file < 0) return false;
+#endif
+    uint64_t bytes = FileBytes();
+    bool fresh = bytes < sizeof(ScoreFileHeader);
+    if (!Map(fresh ? BytesFor(0) : std::max(bytes, BytesFor(0)))) { ScoreStoreClose(); return false; }
+    ScoreFileHeader* h = Header();
+    if (fresh || h->magic != SCORE_MAGIC) {
+        if (!fresh) { ScoreStoreClose(); return false; } // not ours, leave it alone
+        memset(h, 0, sizeof(*h));
+        h->magic = SCORE_MAGIC;
+        h->version = SCORE_VERSION;
+        h->recordSize = sizeof(ScoreRecord);
+    }
+    if (h->version != SCORE_VERSION || h->recordSize != sizeof(ScoreRecord)) { ScoreStoreClose(); return false; }
+    if (h->count > Capacity()) h->count = Capacity(); // torn grow
+    // Room for a session's worth of runs now, so game over never waits on a remap
+    uint64_t count = h->count;
+    if (Capacity() - count < GROW_RECORDS) {
+        Unmap();
+        if (!Map(BytesFor(count + GROW_RECORDS))) { ScoreStoreClose(); return false; }
+    }
+    top.reserve(SCORE_TOP_MAX + 1);
+    const ScoreRecord* r = Records();
+    for (uint64_t i = 0; i < count; i++) {
+        if (r[i].score > SCORE_MAX) continue; // a damaged record stays in the file but is not listed
+        FenwickAdd(r[i].score);
+        TopInsert((long long)i);
+    }
+    return true;
+}
+
+void ScoreStoreClose() {
+    Unmap();
+#ifdef _WIN32
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (file >= 0) close(file);
+    file = -1;
+#endif
+    fenwick.assign(1, 0);
+    fenwickTotal = 0;
+    top.clear();
+}
+
+long long ScoreStoreCount() { return mapped ? (long long)Header()->count : 0; }
+
+long long ScoreStoreAdd(int score, const char* name) {
+    if (!mapped || score > SCORE_MAX) return -1;
+    uint64_t count = Header()->count;
+    if (count == Capacity()) {
+        uint64_t bytes = BytesFor(count + 1);
+        Unmap();
+        if (!Map(bytes)) return -1;
+    }
+    ScoreRecord& r = Records()[count];
+    memset(&r, 0, sizeof(r));
+    r.score = score;
+    r.time = (uint32_t)time(nullptr);
+    strncpy(r.name, name, SCORE_NAME_SIZE - 1);
+    Header()->count = count + 1; // after the record, so a crash never counts a torn one
+    FenwickAdd(score);
+    TopInsert((long long)count);
+    return (long long)count;
+}
+
+void ScoreStoreSetName(long long index, const char* name) {
+    if (!mapped || index < 0 || (uint64_t)index >= Header()->count) return;
+    ScoreRecord& r = Records()[index];
+    memset(r.name, 0, sizeof(r.name));
+    strncpy(r.name, name, SCORE_NAME_SIZE - 1);
+}
+
+long long ScoreStoreRank(int score) { return 1 + (long long)(fenwickTotal - FenwickPrefix(score)); }
+long long ScoreStorePlace(int score) { return 1 + (long long)(fenwickTotal - FenwickPrefix(score - 1)); }
+
+int ScoreStoreTop(ScoreRecord* out, int n) {
+    n = std::min(n, (int)top.size());
+    for (int i = 0; i < n; i++) out[i] = Records()[top[i]];
+    return n;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// ------------ Score Store --------------
+// Every finished run, appended to a memory-mapped file, plus an in-memory
+// Fenwick tree over score values: adding a run and ranking a score are both
+// O(log max score) however many runs are stored. No raylib in here (windows.h).
+#define SCORE_NAME_SIZE 24
+#define SCORE_TOP_MAX 10
+#define SCORE_MAX 1000000  // the index is sized by score: anything above is refused as corrupt
+
+struct ScoreRecord {
+    int32_t score;
+    uint32_t time;               // unix seconds when it was stored
+    char name[SCORE_NAME_SIZE];  // NUL-terminated, may contain spaces
+};
+
+bool ScoreStoreOpen(const char* path);  // maps the file (creating it) and indexes it
+void ScoreStoreClose();
+long long ScoreStoreCount();
+long long ScoreStoreAdd(int score, const char* name); // record index, -1 when not open or above SCORE_MAX
+void ScoreStoreSetName(long long index, const char* name);
+long long ScoreStoreRank(int score);   // 1 + stored runs with a strictly higher score
+long long ScoreStorePlace(int score);  // where a new run would list: 1 + runs scoring at least as much
+int ScoreStoreTop(ScoreRecord* out, int n); // best n (n <= SCORE_TOP_MAX), earlier runs first on ties
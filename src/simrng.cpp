@@ -0,0 +1,31 @@
+#include "simrng.h"
+
+uint64_t simRngState = 0x9E3779B97F4A7C15ull;
+
+static uint64_t Next() {
+    uint64_t x = simRngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    simRngState = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+void SimSeed(uint64_t seed) {
+    // splitmix64 step, so small or similar seeds still start far apart (and never at 0)
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    simRngState = z ? z : 0x9E3779B97F4A7C15ull;
+}
+
+int SimRandomValue(int min, int max) {
+    if (min > max) { int t = min; min = max; max = t; }
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+    return (int)(min + (int64_t)((Next() >> 32) % range));
+}
+
+float SimRandomFloat(float min, float max) {
+    return min + (max - min) * (float)((Next() >> 40) * (1.0 / 16777216.0));
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+// ------------ Simulation RNG --------------
+// Every random draw of the simulation comes from here (xorshift64*) rather than
+// from GetRandomValue() or a std engine, so the whole generator is one word that
+// a run snapshot can carry and a seed can replay.
+extern uint64_t simRngState;
+
+void SimSeed(uint64_t seed);
+int SimRandomValue(int min, int max);       // inclusive, like GetRandomValue()
+float SimRandomFloat(float min, float max); // [min, max)
@@ -0,0 +1,69 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+#define SNAP_MAGIC 0x53524753u // "SGRS"
+
+struct SnapHeader {
+    uint32_t magic, version, layout, size, checksum;
+};
+
+static uint32_t Fnv1a(const uint8_t* data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) { h ^= data[i]; h *= 16777619u; }
+    return h;
+}
+
+void SnapBegin(SnapStream& s, SnapMode mode) {
+    s.mode = mode;
+    s.at = 0;
+    s.ok = true;
+    if (mode == SNAP_SAVE) {
+        s.bytes.clear();
+        if (s.bytes.capacity() == 0) s.bytes.reserve(128 * 1024);
+    }
+}
+
+void SnapBytes(SnapStream& s, void* data, size_t size) {
+    if (!s.ok || size == 0) return;
+    if (s.mode == SNAP_SAVE) {
+        const uint8_t* p = (const uint8_t*)data;
+        s.bytes.insert(s.bytes.end(), p, p + size);
+    } else if (s.at + size <= s.bytes.size()) {
+        memcpy(data, s.bytes.data() + s.at, size);
+        s.at += size;
+    } else {
+        s.ok = false;
+    }
+}
+
+bool SnapWriteFile(const SnapStream& s, const char* path, uint32_t version, uint32_t layout) {
+    if (!s.ok) return false;
+    SnapHeader h = { SNAP_MAGIC, version, layout, (uint32_t)s.bytes.size(), Fnv1a(s.bytes.data(), s.bytes.size()) };
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(s.bytes.data(), s.bytes.size(), 1, f) == 1;
+    ok = fclose(f) == 0 && ok;
+    if (!ok) remove(path);
+    return ok;
+}
+
+bool SnapReadFile(SnapStream& s, const char* path, uint32_t version, uint32_t layout) {
+    SnapBegin(s, SNAP_LOAD);
+    FILE* f = fopen(path, "rb");
+    if (!f) return s.ok = false;
+    // The payload must be exactly what follows the header, so a bad size is refused before it is allocated
+    fseek(f, 0, SEEK_END);
+    long fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    SnapHeader h;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && h.magic == SNAP_MAGIC && h.version == version && h.layout == layout;
+    ok = ok && fileSize >= (long)sizeof(h) && h.size == (unsigned long)(fileSize - (long)sizeof(h));
+    if (ok) {
+        s.bytes.resize(h.size);
+        ok = h.size == 0 || fread(s.bytes.data(), h.size, 1, f) == 1;
+        ok = ok && Fnv1a(s.bytes.data(), s.bytes.size()) == h.checksum;
+    }
+    fclose(f);
+    return s.ok = ok;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// ------------ Snapshot Stream --------------
+// A snapshot is written and read by the same transfer routine: SnapValue and
+// SnapPool copy plain structs into the stream when saving and back out when
+// loading, so the two directions cannot drift apart. The file carries a
+// version, a layout stamp (struct sizes) and a checksum; anything else is refused.
+enum SnapMode { SNAP_SAVE, SNAP_LOAD };
+
+struct SnapStream {
+    SnapMode mode;
+    std::vector<uint8_t> bytes;
+    size_t at;
+    bool ok;
+};
+
+void SnapBegin(SnapStream& s, SnapMode mode);
+void SnapBytes(SnapStream& s, void* data, size_t size);
+
+template <typename T>
+void SnapValue(SnapStream& s, T& value) { SnapBytes(s, &value, sizeof(T)); }
+
+// Loading never grows a pool past the capacity it was reserved with
+template <typename T>
+void SnapPool(SnapStream& s, std::vector<T>& pool) {
+    uint32_t count = (uint32_t)pool.size();
+    SnapValue(s, count);
+    if (s.mode == SNAP_LOAD) {
+        if (!s.ok || count > pool.capacity()) { s.ok = false; return; }
+        pool.resize(count);
+    }
+    SnapBytes(s, pool.data(), count * sizeof(T));
+}
+
+bool SnapWriteFile(const SnapStream& s, const char* path, uint32_t version, uint32_t layout);
+// Fills the stream for SNAP_LOAD; false if missing, truncated, corrupt or from another version/layout
+bool SnapReadFile(SnapStream& s, const char* path, uint32_t version, uint32_t layout);
@@ -0,0 +1,58 @@
+#include "spritequeue.h"
+#include "render.h"
+#include <algorithm>
+#include <vector>
+
+struct Sprite {
+    unsigned long long key; // layer, texture, push order
+    Texture2D texture;
+    Vector2 position;
+    float scale;
+    Color tint;
+};
+
+// Cleared, not freed, each frame; reserved for every sprite the pools can hold
+static std::vector<Sprite> sprites;
+static Rectangle viewRect;
+static SpriteQueueStats stats;
+
+void SpriteQueueReserve(int count) {
+    sprites.reserve(count);
+}
+
+void SpriteQueueBegin(Rectangle view) {
+    sprites.clear();
+    viewRect = view;
+    stats = SpriteQueueStats{};
+}
+
+void SpriteQueuePush(int layer, Texture2D texture, Vector2 position, float scale, Color tint) {
+    stats.queued++;
+    float w = texture.width * scale, h = texture.height * scale;
+    if (position.x >= viewRect.x + viewRect.width || position.x + w <= viewRect.x ||
+        position.y >= viewRect.y + viewRect.height || position.y + h <= viewRect.y) {
+        stats.culled++;
+        return;
+    }
+    // Never drawn ahead of the sort: past the reservation the queue grows instead
+    Sprite s;
+    s.key = ((unsigned long long)(layer & 0xFF) << 56) | ((unsigned long long)(texture.id & 0xFFFFFF) << 32) | (unsigned)sprites.size();
+    s.texture = texture;
+    s.position = position;
+    s.scale = scale;
+    s.tint = tint;
+    sprites.push_back(s);
+}
+
+SpriteQueueStats SpriteQueueFlush() {
+    std::sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) { return a.key < b.key; });
+    int spriteCount = (int)sprites.size();
+    for (int i = 0; i < spriteCount; i++) {
+        const Sprite& s = sprites[i];
+        if (i == 0 || s.texture.id != sprites[i - 1].texture.id) stats.textureRuns++;
+        CmdTextureEx(s.texture, s.position, 0.0f, s.scale, s.tint);
+    }
+    stats.submitted += spriteCount;
+    sprites.clear();
+    return stats;
+}
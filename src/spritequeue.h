@@ -0,0 +1,20 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Sprite Queue --------------
+// Gameplay sprites are queued here instead of drawn directly. On flush, the
+// ones outside the view are dropped and the rest are emitted sorted by layer,
+// then texture, so each texture is bound once per layer. Within one layer and
+// texture the push order is kept.
+struct SpriteQueueStats {
+    int queued;       // pushed this frame
+    int culled;       // entirely outside the view
+    int submitted;    // emitted into the command buffer
+    int textureRuns;  // runs of one texture among the submitted (binds needed)
+};
+
+void SpriteQueueReserve(int count);  // room for count sprites, so a frame does not allocate
+void SpriteQueueBegin(Rectangle view);
+// Lower layers are drawn first; texture drawn at position with the given scale
+void SpriteQueuePush(int layer, Texture2D texture, Vector2 position, float scale, Color tint);
+SpriteQueueStats SpriteQueueFlush();
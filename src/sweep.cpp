@@ -0,0 +1,45 @@
+#include "sweep.h"
+#include <cmath>
+
+#define MAX_MASK_SAMPLES 512
+
+// Narrows [enter, exit] to the times where offset + v * t lies strictly inside (lo, hi)
+static bool ClipAxis(float lo, float hi, float v, float& enter, float& exit) {
+    if (v == 0.0f) return lo < 0.0f && 0.0f < hi;
+    float t0 = lo / v, t1 = hi / v;
+    if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+    if (t0 > enter) enter = t0;
+    if (t1 < exit) exit = t1;
+    return enter < exit;
+}
+
+SweepResult SweptAabb(Rectangle a, Vector2 da, Rectangle b, Vector2 db) {
+    // Move a relative to b; strict inequalities match CheckCollisionRecs
+    SweepResult r = { false, 0.0f, 1.0f };
+    float vx = da.x - db.x, vy = da.y - db.y;
+    if (!ClipAxis(b.x - (a.x + a.width), b.x + b.width - a.x, vx, r.enter, r.exit)) return r;
+    if (!ClipAxis(b.y - (a.y + a.height), b.y + b.height - a.y, vy, r.enter, r.exit)) return r;
+    r.hit = true;
+    return r;
+}
+
+bool SweptMaskHit(const HitMask& ma, Rectangle a, Vector2 da, const HitMask& mb, Rectangle b, Vector2 db, float* toi) {
+    SweepResult s = SweptAabb(a, da, b, db);
+    if (!s.hit) return false;
+    // Masks line up on whole cells, so the pair only changes every HITMASK_CELL of
+    // relative motion; samples half a cell apart, ends included, see every offset
+    float rel = fmaxf(fabsf(da.x - db.x), fabsf(da.y - db.y)) * (s.exit - s.enter);
+    int samples = (int)ceilf(rel / (HITMASK_CELL * 0.5f));
+    if (samples < 1) samples = 1;
+    if (samples > MAX_MASK_SAMPLES) samples = MAX_MASK_SAMPLES;
+    for (int i = 0; i <= samples; i++) {
+        float t = s.enter + (s.exit - s.enter) * i / samples;
+        Vector2 pa = { a.x + da.x * t, a.y + da.y * t };
+        Vector2 pb = { b.x + db.x * t, b.y + db.y * t };
+        if (HitMasksOverlap(ma, pa, mb, pb)) {
+            if (toi) *toi = t;
+            return true;
+        }
+    }
+    return false;
+}
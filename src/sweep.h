@@ -0,0 +1,16 @@
+#pragma once
+#include "raylib.h"
+#include "hitmask.h"
+
+// ------------ Swept Collision --------------
+// Continuous tests over one tick: each box moves linearly by its delta, so a hit
+// is found however far things travel in a tick. Times are fractions of the tick.
+struct SweepResult {
+    bool hit;
+    float enter, exit;   // overlap interval within [0, 1]; enter is the time of impact
+};
+
+SweepResult SweptAabb(Rectangle a, Vector2 da, Rectangle b, Vector2 db);
+// Swept boxes, then the masks sampled across the overlap interval half a mask
+// cell of relative motion apart. *toi is the first sample that touches.
+bool SweptMaskHit(const HitMask& ma, Rectangle a, Vector2 da, const HitMask& mb, Rectangle b, Vector2 db, float* toi);
@@ -0,0 +1,120 @@
+#include "telemetry.h"
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+#ifndef BUILD_ID
+#define BUILD_ID __DATE__ " " __TIME__
+#endif
+
+#define TELEMETRY_QUEUE 8
+
+static const char* logPath = nullptr;
+static std::thread writer;
+static std::mutex queueLock;
+static std::condition_variable queueWake;
+static TelemetryRecord queue[TELEMETRY_QUEUE];
+static int queueHead = 0, queueCount = 0;
+static bool stopping = false;
+
+static bool running = false;
+static TelemetryRecord run;
+static uint64_t runHist[TELEMETRY_BINS];
+
+static void WriterLoop() {
+    std::unique_lock<std::mutex> lock(queueLock);
+    for (;;) {
+        queueWake.wait(lock, [] { return queueCount > 0 || stopping; });
+        if (queueCount == 0) return;
+        TelemetryRecord rec = queue[queueHead];
+        queueHead = (queueHead + 1) % TELEMETRY_QUEUE;
+        queueCount--;
+        lock.unlock();
+        FILE* f = fopen(logPath, "ab");
+        if (f) {
+            fwrite(&rec, sizeof(rec), 1, f);
+            fclose(f);
+        }
+        lock.lock();
+    }
+}
+
+void TelemetryInit(const char* path) {
+    logPath = path;
+    stopping = false;
+    writer = std::thread(WriterLoop);
+}
+
+void TelemetryShutdown() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        stopping = true;
+    }
+    queueWake.notify_one();
+    writer.join();
+}
+
+void TelemetryBeginRun() {
+    memset(&run, 0, sizeof(run));
+    memset(runHist, 0, sizeof(runHist));
+    run.magic = TELEMETRY_MAGIC;
+    run.version = TELEMETRY_VERSION;
+    run.size = sizeof(TelemetryRecord);
+    strncpy(run.build, BUILD_ID, sizeof(run.build) - 1);
+    run.startTime = (uint32_t)time(nullptr);
+    running = true;
+}
+
+void TelemetryFrame(float seconds, float budget) {
+    if (!running) return;
+    float ms = seconds * 1000.0f;
+    runHist[TelemetryBin(ms)]++;
+    run.frames++;
+    run.duration += seconds;
+    if (ms > run.maxFrame) run.maxFrame = ms;
+    if (budget > 0.0f && seconds > 2.0f * budget) run.hitches++;
+}
+
+static void Peak(uint16_t& peak, int count) {
+    if (count > 0xFFFF) count = 0xFFFF;
+    if (count > peak) peak = (uint16_t)count;
+}
+
+void TelemetryEntities(int coins, int birds, int rocks, int particles, int rainDrops) {
+    if (!running) return;
+    Peak(run.peakCoins, coins);
+    Peak(run.peakBirds, birds);
+    Peak(run.peakRocks, rocks);
+    Peak(run.peakParticles, particles);
+    Peak(run.peakRainDrops, rainDrops);
+}
+
+void TelemetryEndRun(DeathCause death, int score, int rainPeriods) {
+    if (!running) return;
+    running = false;
+    if (run.frames == 0) return;
+    run.death = death;
+    run.score = (uint32_t)score;
+    run.rainPeriods = (uint8_t)rainPeriods;
+    for (int b = 0; b < TELEMETRY_BINS; b++) run.hist[b] = (uint32_t)runHist[b];
+    run.p50 = TelemetryPercentile(runHist, run.frames, 0.50f, run.maxFrame);
+    run.p95 = TelemetryPercentile(runHist, run.frames, 0.95f, run.maxFrame);
+    run.p99 = TelemetryPercentile(runHist, run.frames, 0.99f, run.maxFrame);
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        if (queueCount == TELEMETRY_QUEUE) return; // writer stuck on a slow disk, drop the run
+        queue[(queueHead + queueCount) % TELEMETRY_QUEUE] = run;
+        queueCount++;
+    }
+    queueWake.notify_one();
+}
+
+const char* DeathCauseName(int death) {
+    static const char* names[DEATH_CAUSE_COUNT] = { "quit", "rock", "bird" };
+    return death >= 0 && death < DEATH_CAUSE_COUNT ? names[death] : "?";
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+// ------------ Run Telemetry --------------
+// One fixed-size binary record per GAME run, appended to a log file by a
+// background writer thread when the run ends. tools/telemetry_summary.cpp reads
+// the logs back. No raylib in here so the tool can share the record layout.
+#define TELEMETRY_MAGIC 0x4C544753u  // "SGTL" little-endian
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_BINS 96            // frame-time histogram: < 1 ms, then 12 bins per doubling (~6% wide)
+
+enum DeathCause : uint8_t { DEATH_NONE, DEATH_ROCK, DEATH_BIRD, DEATH_CAUSE_COUNT }; // NONE = left the run
+
+#pragma pack(push, 4)
+struct TelemetryRecord {
+    uint32_t magic;
+    uint16_t version, size;          // size lets readers skip records of a later version
+    char build[24];                  // BUILD_ID of the game that wrote it
+    uint32_t startTime;              // unix seconds
+    float duration;                  // seconds spent in GAME (unpaused)
+    uint32_t frames;
+    uint32_t hitches;                // frames longer than twice the frame budget
+    float p50, p95, p99, maxFrame;   // frame time, milliseconds
+    uint16_t peakCoins, peakBirds, peakRocks, peakParticles, peakRainDrops;
+    uint8_t rainPeriods, death;
+    uint32_t score;
+    uint32_t hist[TELEMETRY_BINS];
+};
+#pragma pack(pop)
+static_assert(sizeof(TelemetryRecord) == 464, "telemetry record layout changed, bump TELEMETRY_VERSION");
+
+inline int TelemetryBin(float ms) {
+    if (ms < 1.0f) return 0;
+    int bin = 1 + (int)(12.0f * log2f(ms));
+    return bin < TELEMETRY_BINS ? bin : TELEMETRY_BINS - 1;
+}
+inline float TelemetryBinUpperMs(int bin) { return exp2f(bin / 12.0f); }
+
+// Percentile of a histogram (upper edge of the bin it falls in), never above maxMs
+inline float TelemetryPercentile(const uint64_t* hist, uint64_t total, float p, float maxMs) {
+    uint64_t want = (uint64_t)ceil(p * total), seen = 0;
+    for (int b = 0; b < TELEMETRY_BINS; b++) {
+        seen += hist[b];
+        if (seen >= want && seen > 0) return fminf(TelemetryBinUpperMs(b), maxMs);
+    }
+    return maxMs;
+}
+
+void TelemetryInit(const char* path);   // starts the writer thread
+void TelemetryShutdown();               // writes what is queued, joins the writer
+void TelemetryBeginRun();
+void TelemetryFrame(float seconds, float budget);
+void TelemetryEntities(int coins, int birds, int rocks, int particles, int rainDrops);
+// Finishes the running run (no-op without one) and queues its record
+void TelemetryEndRun(DeathCause death, int score, int rainPeriods);
+const char* DeathCauseName(int death);
@@ -0,0 +1,255 @@
+#include "textcache.h"
+#include "render.h"
+#include "uicache.h"
+#include "assets.h"
+#include "rlgl.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// ------------ Text Cache --------------
+#define WIDTH_SLOTS 256
+#define WIDTH_PROBES 8
+
+struct WidthEntry { unsigned long long key; int width; bool used; };
+static WidthEntry widths[WIDTH_SLOTS];
+
+static unsigned long long TextKey(const char* text, int fontSize) {
+    return HashBytes(text, strlen(text), HashBytes(&fontSize, sizeof(fontSize)));
+}
+
+int TextWidth(const char* text, int fontSize) {
+    unsigned long long key = TextKey(text, fontSize);
+    for (int i = 0; i < WIDTH_PROBES; i++) {
+        WidthEntry& e = widths[(key + i) % WIDTH_SLOTS];
+        if (e.used && e.key == key) return e.width;
+        if (!e.used) {
+            e.key = key;
+            e.width = MeasureText(text, fontSize);
+            e.used = true;
+            return e.width;
+        }
+    }
+    return MeasureText(text, fontSize); // crowded slot range, measured every time
+}
+
+const char* TextFieldInt(TextField& field, const char* fmt, int value) {
+    if (!field.valid || field.shown != value) {
+        snprintf(field.text, sizeof(field.text), fmt, value);
+        field.shown = value;
+        field.valid = true;
+    }
+    return field.text;
+}
+
+const char* TextFieldFloat(TextField& field, const char* fmt, float value, float step) {
+    long long shown = llroundf(value / step);
+    if (!field.valid || field.shown != shown) {
+        snprintf(field.text, sizeof(field.text), fmt, shown * step);
+        field.shown = shown;
+        field.valid = true;
+    }
+    return field.text;
+}
+
+// ------------ SDF Text --------------
+#define SDF_UPSCALE 4        // atlas texels per font pixel
+#define SDF_SPREAD 8         // atlas texels of distance kept on each side of an edge
+#define SDF_ATLAS_SIZE 512
+#define SDF_FIRST_CHAR 32
+#define SDF_CHAR_COUNT 95    // printable ASCII
+
+struct SdfGlyph {
+    Rectangle cell;          // in the atlas, SDF_SPREAD around the glyph
+    float advance, offsetX, offsetY;
+};
+
+struct SdfString {
+    unsigned long long key;
+    RenderTexture2D target;
+    int pad;                 // pixels around the MeasureText() box
+    unsigned int lastUse;
+};
+
+static bool sdfReady = false;
+static Texture2D sdfAtlas;
+static Shader sdfShader;
+static SdfGlyph sdfGlyphs[SDF_CHAR_COUNT];
+static int sdfBaseSize = 10;
+static SdfString sdfStrings[TEXT_SDF_STRINGS];
+static unsigned int sdfUses = 0;
+
+static const char* sdfFs =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    float d = texture(texture0, fragTexCoord).a - 0.5;\n"
+    "    float w = max(length(vec2(dFdx(d), dFdy(d))), 0.0001);\n"
+    "    finalColor = vec4(1.0, 1.0, 1.0, smoothstep(-w, w, d));\n"
+    "}\n";
+
+// Glyph coverage at atlas resolution: the font pixels bilinearly filtered and
+// cut at half coverage, which rounds the bitmap's stair steps into slopes
+static bool GlyphInside(const float* cov, int gw, int gh, int x, int y) {
+    float u = (x + 0.5f) / SDF_UPSCALE - 0.5f, v = (y + 0.5f) / SDF_UPSCALE - 0.5f;
+    int x0 = (int)floorf(u), y0 = (int)floorf(v);
+    float fx = u - x0, fy = v - y0;
+    float c[4];
+    for (int i = 0; i < 4; i++) {
+        int px = x0 + (i & 1), py = y0 + (i >> 1);
+        c[i] = (px < 0 || py < 0 || px >= gw || py >= gh) ? 0.0f : cov[py * gw + px];
+    }
+    float top = c[0] + (c[1] - c[0]) * fx, bottom = c[2] + (c[3] - c[2]) * fx;
+    return top + (bottom - top) * fy >= 0.5f;
+}
+
+// Writes one glyph's distance field into the atlas at (ax, ay)
+static void BakeGlyph(unsigned char* atlas, const float* cov, int gw, int gh, int ax, int ay) {
+    int w = gw * SDF_UPSCALE, h = gh * SDF_UPSCALE;
+    int cw = w + 2 * SDF_SPREAD, ch = h + 2 * SDF_SPREAD;
+    static bool mask[(16 * SDF_UPSCALE + 2 * SDF_SPREAD) * (16 * SDF_UPSCALE + 2 * SDF_SPREAD)];
+    for (int y = 0; y < ch; y++)
+        for (int x = 0; x < cw; x++) {
+            int hx = x - SDF_SPREAD, hy = y - SDF_SPREAD;
+            mask[y * cw + x] = hx >= 0 && hy >= 0 && hx < w && hy < h && GlyphInside(cov, gw, gh, hx, hy);
+        }
+    const int r = SDF_SPREAD + 1;
+    for (int y = 0; y < ch; y++) {
+        for (int x = 0; x < cw; x++) {
+            bool in = mask[y * cw + x];
+            int best = r * r;
+            for (int dy = -r; dy <= r; dy++) {
+                if (dy * dy >= best) continue;
+                int sy = y + dy;
+                for (int dx = -r; dx <= r; dx++) {
+                    int sx = x + dx;
+                    bool other = (sx < 0 || sy < 0 || sx >= cw || sy >= ch) ? false : mask[sy * cw + sx];
+                    if (other != in && dx * dx + dy * dy < best) best = dx * dx + dy * dy;
+                }
+            }
+            float d = sqrtf((float)best) - 0.5f;
+            float a = 0.5f + (in ? d : -d) / (2.0f * SDF_SPREAD);
+            a = a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+            unsigned char* p = atlas + ((ay + y) * SDF_ATLAS_SIZE + ax + x) * 4;
+            p[0] = p[1] = p[2] = 255;
+            p[3] = (unsigned char)(a * 255.0f + 0.5f);
+        }
+    }
+}
+
+void TextSdfInit() {
+    if (sdfReady || GetRenderBackend() != RENDER_BACKEND_RAYLIB) return;
+    Font font = GetFontDefault();
+    if (font.glyphs == nullptr || font.baseSize <= 0) return;
+    sdfBaseSize = font.baseSize;
+
+    Image atlas = GenImageColor(SDF_ATLAS_SIZE, SDF_ATLAS_SIZE, (Color){ 255, 255, 255, 0 });
+    static float cov[16 * 16];
+    int x = 0, y = 0, rowH = 0;
+    bool fits = true;
+    for (int i = 0; i < SDF_CHAR_COUNT && fits; i++) {
+        int idx = GetGlyphIndex(font, SDF_FIRST_CHAR + i);
+        const GlyphInfo& g = font.glyphs[idx];
+        int gw = (int)font.recs[idx].width, gh = (int)font.recs[idx].height;
+        if (gw > 16 || gh > 16 || g.image.data == nullptr) { fits = false; break; }
+        for (int py = 0; py < gh; py++)
+            for (int px = 0; px < gw; px++) cov[py * gw + px] = GetImageColor(g.image, px, py).a / 255.0f;
+
+        int cw = gw * SDF_UPSCALE + 2 * SDF_SPREAD, ch = gh * SDF_UPSCALE + 2 * SDF_SPREAD;
+        if (x + cw > SDF_ATLAS_SIZE) { x = 0; y += rowH; rowH = 0; }
+        if (y + ch > SDF_ATLAS_SIZE) { fits = false; break; }
+        BakeGlyph((unsigned char*)atlas.data, cov, gw, gh, x, y);
+        sdfGlyphs[i].cell = { (float)x, (float)y, (float)cw, (float)ch };
+        sdfGlyphs[i].advance = g.advanceX != 0 ? (float)g.advanceX : font.recs[idx].width;
+        sdfGlyphs[i].offsetX = (float)g.offsetX;
+        sdfGlyphs[i].offsetY = (float)g.offsetY;
+        x += cw;
+        if (ch > rowH) rowH = ch;
+    }
+    if (fits) {
+        sdfAtlas = LoadTextureFromImage(atlas);
+        SetTextureFilter(sdfAtlas, TEXTURE_FILTER_BILINEAR);
+        AssetTrackTexture(sdfAtlas, "sdf font atlas", "text");
+        sdfShader = LoadShaderFromMemory(0, sdfFs);
+        sdfReady = sdfAtlas.id != 0 && IsShaderReady(sdfShader);
+    }
+    UnloadImage(atlas);
+}
+
+void TextSdfUnload() {
+    for (int i = 0; i < TEXT_SDF_STRINGS; i++) {
+        if (sdfStrings[i].target.id != 0) {
+            AssetUntrack(sdfStrings[i].target.texture);
+            UnloadRenderTexture(sdfStrings[i].target);
+        }
+        sdfStrings[i] = SdfString{};
+    }
+    if (!sdfReady) return;
+    AssetUnloadTexture(sdfAtlas);
+    UnloadShader(sdfShader);
+    sdfReady = false;
+}
+
+// Renders the string white into s.target, coverage in alpha, laid out like DrawText()
+static void BakeString(SdfString& s, const char* text, int fontSize) {
+    float scale = (float)fontSize / sdfBaseSize;
+    int spacing = fontSize / 10;  // DrawText()'s spacing for the default font
+    s.pad = (int)ceilf(SDF_SPREAD * scale / SDF_UPSCALE);
+    int w = TextWidth(text, fontSize) + 2 * s.pad, h = fontSize + 2 * s.pad;
+    if (s.target.id != 0 && (s.target.texture.width != w || s.target.texture.height != h)) {
+        AssetUntrack(s.target.texture);
+        UnloadRenderTexture(s.target);
+        s.target = RenderTexture2D{};
+    }
+    if (s.target.id == 0) {
+        s.target = LoadRenderTexture(w, h);
+        AssetTrackRenderTexture(s.target, "sdf string", "text");
+    }
+
+    BeginTextureMode(s.target);
+    ClearBackground((Color){ 255, 255, 255, 0 });
+    // Alpha takes the larger coverage where padded glyph cells overlap
+    rlSetBlendFactorsSeparate(RL_ONE, RL_ZERO, RL_ONE, RL_ONE, RL_FUNC_ADD, RL_MAX);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    BeginShaderMode(sdfShader);
+    float penX = (float)s.pad, spread = (float)SDF_SPREAD / SDF_UPSCALE;
+    for (const char* c = text; *c; c++) {
+        int i = (unsigned char)*c - SDF_FIRST_CHAR;
+        if (i < 0 || i >= SDF_CHAR_COUNT) i = '?' - SDF_FIRST_CHAR;
+        const SdfGlyph& g = sdfGlyphs[i];
+        Rectangle dest = { penX + (g.offsetX - spread) * scale, s.pad + (g.offsetY - spread) * scale,
+                           g.cell.width / SDF_UPSCALE * scale, g.cell.height / SDF_UPSCALE * scale };
+        if (*c != ' ') DrawTexturePro(sdfAtlas, g.cell, dest, { 0, 0 }, 0.0f, WHITE);
+        penX += g.advance * scale + spacing;
+    }
+    EndShaderMode();
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void CmdTextLarge(const char* text, int posX, int posY, int fontSize, Color color) {
+    if (!sdfReady || fontSize < SDF_TEXT_MIN_SIZE || text[0] == '\0') {
+        CmdText(text, posX, posY, fontSize, color);
+        return;
+    }
+    unsigned long long key = TextKey(text, fontSize);
+    SdfString* s = nullptr;
+    SdfString* oldest = &sdfStrings[0];
+    for (int i = 0; i < TEXT_SDF_STRINGS && !s; i++) {
+        if (sdfStrings[i].target.id != 0 && sdfStrings[i].key == key) s = &sdfStrings[i];
+        else if (sdfStrings[i].lastUse < oldest->lastUse) oldest = &sdfStrings[i];
+    }
+    if (!s) {
+        s = oldest;
+        s->key = key;
+        BakeString(*s, text, fontSize);
+    }
+    s->lastUse = ++sdfUses;
+    const Texture2D& tex = s->target.texture;
+    // Render textures are stored upside down
+    CmdTexturePro(tex, { 0, 0, (float)tex.width, -(float)tex.height },
+        { (float)(posX - s->pad), (float)(posY - s->pad), (float)tex.width, (float)tex.height }, { 0, 0 }, 0.0f, color);
+}
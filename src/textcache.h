@@ -0,0 +1,30 @@
+#pragma once
+#include "raylib.h"
+
+// ------------ Text Cache --------------
+// Widths of strings drawn every frame are measured once and looked up by content.
+int TextWidth(const char* text, int fontSize);
+
+// A formatted number that is only reformatted when the shown value changes. The
+// buffer stays put, so it can be recorded with CmdTextStatic().
+struct TextField {
+    bool valid;
+    long long shown;
+    char text[64];
+};
+const char* TextFieldInt(TextField& field, const char* fmt, int value);
+// Reformats when value moves to another multiple of step (0.1f for "%.1f")
+const char* TextFieldFloat(TextField& field, const char* fmt, float value, float step);
+
+// ------------ SDF Text --------------
+// Text of at least SDF_TEXT_MIN_SIZE is drawn from a signed-distance-field atlas
+// built from the default font, so it stays sharp instead of showing upscaled
+// bitmap pixels. Each string is rendered once into its own texture and drawn as
+// a single quad; the TEXT_SDF_STRINGS most recently used strings are kept.
+#define SDF_TEXT_MIN_SIZE 48
+#define TEXT_SDF_STRINGS 16
+
+void TextSdfInit();   // after InitWindow(); without it large text falls back to CmdText()
+void TextSdfUnload();
+// Same placement as CmdText(): (posX, posY) is the top-left of the MeasureText() box
+void CmdTextLarge(const char* text, int posX, int posY, int fontSize, Color color);
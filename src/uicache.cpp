@@ -0,0 +1,69 @@
+#include "uicache.h"
+#include "render.h"
+#include "assets.h"
+#include "rlgl.h"
+
+unsigned long long HashBytes(const void* data, size_t size, unsigned long long seed) {
+    // FNV-1a
+    const unsigned char* p = (const unsigned char*)data;
+    unsigned long long h = seed;
+    for (size_t i = 0; i < size; i++) { h ^= p[i]; h *= 1099511628211ULL; }
+    return h;
+}
+
+bool UiCacheBegin(UiCache& cache, Rectangle bounds, unsigned long long key) {
+    if (cache.valid && cache.key == key) return false;
+
+    int w = (int)bounds.width, h = (int)bounds.height;
+    bool gpu = GetRenderBackend() == RENDER_BACKEND_RAYLIB;
+    if (cache.target.texture.width != w || cache.target.texture.height != h) {
+        UiCacheUnload(cache);
+        if (gpu) {
+            cache.target = LoadRenderTexture(w, h);
+            AssetTrackRenderTexture(cache.target, "panel cache", "ui");
+        }
+        else { cache.target.texture.width = w; cache.target.texture.height = h; }
+    }
+    cache.bounds = bounds;
+    cache.key = key;
+
+    if (gpu) {
+        BeginTextureMode(cache.target);
+        ClearBackground(BLANK);
+        // Keep color premultiplied and alpha correct inside the texture, so the
+        // panel looks the same composited once as when it was drawn directly
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    }
+    RenderBeginTarget((int)bounds.x, (int)bounds.y, w, h);
+    return true;
+}
+
+void UiCacheEnd(UiCache& cache) {
+    RenderFlush();
+    if (GetRenderBackend() == RENDER_BACKEND_RAYLIB) {
+        EndBlendMode();
+        EndTextureMode();
+    }
+    cache.valid = true;
+    cache.rebuilds++;
+}
+
+void UiCacheDraw(const UiCache& cache, float offsetX, float offsetY) {
+    if (!cache.valid) return;
+    const Texture2D& tex = cache.target.texture;
+    // Render textures are stored upside down
+    CmdTexturePremultiplied(tex, { 0, 0, (float)tex.width, -(float)tex.height },
+        { cache.bounds.x + offsetX, cache.bounds.y + offsetY, (float)tex.width, (float)tex.height });
+}
+
+void UiCacheInvalidate(UiCache& cache) { cache.valid = false; }
+
+void UiCacheUnload(UiCache& cache) {
+    if (cache.target.id != 0) {
+        AssetUntrack(cache.target.texture);
+        UnloadRenderTexture(cache.target);
+    }
+    cache.target = RenderTexture2D{};
+    cache.valid = false;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+
+// ------------ Retained UI Panels --------------
+// A panel is drawn once into its own render texture and composited as one quad
+// until its key (a hash of everything the panel shows) changes.
+struct UiCache {
+    RenderTexture2D target;
+    Rectangle bounds;        // screen area the panel was recorded for
+    unsigned long long key;
+    bool valid;
+    int rebuilds;
+};
+
+unsigned long long HashBytes(const void* data, size_t size, unsigned long long seed = 1469598103934665603ULL);
+
+// Returns true when the panel has to be redrawn. The caller then records the
+// panel with the usual Cmd* calls (screen coordinates) and calls UiCacheEnd().
+// Must run before RenderBegin() of the frame, it reuses the command buffer.
+bool UiCacheBegin(UiCache& cache, Rectangle bounds, unsigned long long key);
+void UiCacheEnd(UiCache& cache);
+void UiCacheDraw(const UiCache& cache, float offsetX = 0.0f, float offsetY = 0.0f);
+void UiCacheInvalidate(UiCache& cache);
+void UiCacheUnload(UiCache& cache);
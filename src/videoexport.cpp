@@ -0,0 +1,174 @@
+#include "videoexport.h"
+#include "raylib.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MakeDir(path) mkdir(path, 0755)
+#endif
+
+#define EXPORT_QUEUE_PER_THREAD 3
+
+struct ExportJob {
+    int index;
+    unsigned char* rgba;
+};
+
+static bool active = false, y4m = false, stopping = false;
+static char outPath[512];
+static int frameWidth = 0, frameHeight = 0, frameRate = 60, framesQueued = 0, nextToWrite = 0;
+static size_t queueLimit = 0;
+static FILE* stream = nullptr;
+static long long streamBytes = 0;
+static double stallSeconds = 0.0;
+static std::chrono::steady_clock::time_point startTime;
+static std::vector<std::thread> pool;
+static std::deque<ExportJob> queue;
+static std::mutex lock;
+static std::condition_variable jobReady, slotFree, turnTaken;
+
+static bool EndsWith(const char* s, const char* suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// BT.601 full range (C420jpeg), chroma averaged over 2x2 blocks; two rows per pass
+static inline unsigned char Luma(const unsigned char* p) { return (unsigned char)((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8); }
+static inline unsigned char Clamp255(int v) { return (unsigned char)(v < 0 ? 0 : v > 255 ? 255 : v); }
+
+static void RgbaToI420(const unsigned char* rgba, int w, int h, unsigned char* out) {
+    int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    unsigned char* yPlane = out;
+    unsigned char* uPlane = out + (size_t)w * h;
+    unsigned char* vPlane = uPlane + (size_t)cw * ch;
+    for (int cy = 0; cy < ch; cy++) {
+        int y0 = cy * 2, y1 = y0 + 1 < h ? y0 + 1 : y0; // an odd last row pairs with itself
+        const unsigned char* r0 = rgba + (size_t)y0 * w * 4;
+        const unsigned char* r1 = rgba + (size_t)y1 * w * 4;
+        unsigned char* yRow0 = yPlane + (size_t)y0 * w;
+        unsigned char* yRow1 = yPlane + (size_t)y1 * w;
+        unsigned char* uRow = uPlane + (size_t)cy * cw;
+        unsigned char* vRow = vPlane + (size_t)cy * cw;
+        for (int cx = 0; cx < cw; cx++) {
+            int x0 = cx * 2, x1 = x0 + 1 < w ? x0 + 1 : x0;
+            const unsigned char *a = r0 + x0 * 4, *b = r0 + x1 * 4, *c = r1 + x0 * 4, *d = r1 + x1 * 4;
+            yRow0[x0] = Luma(a); yRow0[x1] = Luma(b);
+            yRow1[x0] = Luma(c); yRow1[x1] = Luma(d);
+            int r = (a[0] + b[0] + c[0] + d[0] + 2) >> 2;
+            int g = (a[1] + b[1] + c[1] + d[1] + 2) >> 2;
+            int bl = (a[2] + b[2] + c[2] + d[2] + 2) >> 2;
+            uRow[cx] = Clamp255(((-43 * r - 85 * g + 128 * bl + 128) >> 8) + 128);
+            vRow[cx] = Clamp255(((128 * r - 107 * g - 21 * bl + 128) >> 8) + 128);
+        }
+    }
+}
+
+static void EncodeLoop() {
+    std::vector<unsigned char> yuv;
+    for (;;) {
+        ExportJob job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            jobReady.wait(guard, [] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping and drained
+            job = queue.front();
+            queue.pop_front();
+        }
+        slotFree.notify_one();
+        if (y4m) {
+            yuv.resize((size_t)frameWidth * frameHeight + 2 * (size_t)((frameWidth + 1) / 2) * ((frameHeight + 1) / 2));
+            RgbaToI420(job.rgba, frameWidth, frameHeight, yuv.data());
+            std::unique_lock<std::mutex> guard(lock);
+            turnTaken.wait(guard, [&] { return nextToWrite == job.index; }); // the stream is in frame order
+            fwrite("FRAME\n", 1, 6, stream);
+            fwrite(yuv.data(), 1, yuv.size(), stream);
+            streamBytes += 6 + (long long)yuv.size();
+            nextToWrite++;
+            guard.unlock();
+            turnTaken.notify_all();
+        } else {
+            char path[600];
+            snprintf(path, sizeof(path), "%s/frame_%06d.png", outPath, job.index);
+            Image img = { job.rgba, frameWidth, frameHeight, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            ExportImage(img, path);
+        }
+        free(job.rgba);
+    }
+}
+
+bool ExportBegin(const char* path, int fps, int threads) {
+    if (active) return false;
+    strncpy(outPath, path, sizeof(outPath) - 1);
+    y4m = EndsWith(path, ".y4m");
+    if (!y4m) MakeDir(path);
+    else if (!(stream = fopen(path, "wb"))) return false;
+    if (threads <= 0) {
+        int cores = (int)std::thread::hardware_concurrency();
+        threads = cores > 2 ? cores - 1 : 1;
+    }
+    frameRate = fps;
+    frameWidth = frameHeight = 0;
+    framesQueued = nextToWrite = 0;
+    streamBytes = 0;
+    stallSeconds = 0.0;
+    stopping = false;
+    queueLimit = (size_t)threads * EXPORT_QUEUE_PER_THREAD;
+    startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; i++) pool.emplace_back(EncodeLoop);
+    active = true;
+    return true;
+}
+
+void ExportFrame(unsigned char* rgba, int width, int height) {
+    if (!active || !rgba) { free(rgba); return; }
+    if (frameWidth == 0) {
+        frameWidth = width;
+        frameHeight = height;
+        if (y4m) streamBytes += fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, frameRate);
+    }
+    if (width != frameWidth || height != frameHeight) { free(rgba); return; } // the window was resized
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (queue.size() >= queueLimit) {
+            auto waitStart = std::chrono::steady_clock::now();
+            slotFree.wait(guard, [] { return queue.size() < queueLimit; });
+            stallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count();
+        }
+        queue.push_back({ framesQueued++, rgba });
+    }
+    jobReady.notify_one();
+}
+
+ExportStats ExportEnd() {
+    ExportStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!active) return stats;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    stats.threads = (int)pool.size();
+    for (auto& t : pool) t.join();
+    pool.clear();
+    if (stream) { fclose(stream); stream = nullptr; }
+    active = false;
+    stats.frames = framesQueued;
+    stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    stats.stallSeconds = stallSeconds;
+    stats.bytes = streamBytes;
+    return stats;
+}
+
+bool ExportActive() { return active; }
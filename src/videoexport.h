@@ -0,0 +1,20 @@
+#pragma once
+
+// ------------ Video Export --------------
+// Frames read back from the screen are handed to a pool of encoder threads, so
+// the render loop only waits when the whole queue is full. A path ending in
+// ".y4m" is written as one YUV4MPEG2 (4:2:0) stream, in frame order; any other
+// path is a directory that receives a numbered PNG sequence.
+struct ExportStats {
+    int frames;
+    int threads;
+    double wallSeconds;      // ExportBegin to ExportEnd
+    double stallSeconds;     // render loop time spent waiting for a queue slot
+    long long bytes;         // Y4M output size (PNG sizes are not tracked)
+};
+
+bool ExportBegin(const char* path, int fps, int threads); // threads 0 = one per core, minus the renderer
+// Takes ownership of a malloc'd RGBA8 frame (e.g. LoadImageFromScreen().data); every frame has the first one's size
+void ExportFrame(unsigned char* rgba, int width, int height);
+ExportStats ExportEnd();   // drains the queue and joins the pool
+bool ExportActive();
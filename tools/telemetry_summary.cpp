@@ -0,0 +1,116 @@
+// Aggregates run telemetry logs (telemetry.bin, written by the game) per build.
+//   telemetry_summary [--csv] FILE...
+// Frame-time percentiles come from the merged histograms of every run of a build,
+// so one long run weighs more than a short one, as a player would feel it.
+#include "../src/telemetry.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+struct BuildSummary {
+    std::string build;
+    uint32_t firstStart = 0xFFFFFFFFu;
+    int runs = 0;
+    double seconds = 0.0;
+    uint64_t frames = 0, hitches = 0;
+    uint64_t hist[TELEMETRY_BINS] = {};
+    float maxFrame = 0.0f;
+    std::vector<float> runP95;
+    int deaths[DEATH_CAUSE_COUNT] = {};
+    double peakParticles = 0.0, peakBirds = 0.0, peakRainDrops = 0.0, rainPeriods = 0.0, score = 0.0;
+};
+
+static std::map<std::string, BuildSummary> builds;
+static long long skipped = 0;
+
+static void Add(const TelemetryRecord& r) {
+    std::string build(r.build, strnlen(r.build, sizeof(r.build)));
+    BuildSummary& b = builds[build];
+    b.build = build;
+    if (r.startTime < b.firstStart) b.firstStart = r.startTime;
+    b.runs++;
+    b.seconds += r.duration;
+    b.frames += r.frames;
+    b.hitches += r.hitches;
+    for (int i = 0; i < TELEMETRY_BINS; i++) b.hist[i] += r.hist[i];
+    b.maxFrame = std::max(b.maxFrame, r.maxFrame);
+    b.runP95.push_back(r.p95);
+    if (r.death < DEATH_CAUSE_COUNT) b.deaths[r.death]++;
+    b.peakParticles += r.peakParticles;
+    b.peakBirds += r.peakBirds;
+    b.peakRainDrops += r.peakRainDrops;
+    b.rainPeriods += r.rainPeriods;
+    b.score += r.score;
+}
+
+static void ReadLog(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { fprintf(stderr, "%s: cannot open\n", path); return; }
+    std::vector<unsigned char> data;
+    unsigned char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    size_t at = 0;
+    while (at + 8 <= data.size()) {
+        TelemetryRecord r;
+        memcpy(&r, &data[at], 8);
+        if (r.magic != TELEMETRY_MAGIC || r.size < 8) {
+            fprintf(stderr, "%s: bad record at byte %lld, rest of file skipped\n", path, (long long)at);
+            return;
+        }
+        if (r.size < sizeof(r) || at + r.size > data.size()) { // older layout or torn write
+            skipped++;
+            at += r.size;
+            continue;
+        }
+        memcpy(&r, &data[at], sizeof(r)); // newer versions only append fields
+        Add(r);
+        at += r.size;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    int files = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else { ReadLog(argv[i]); files++; }
+    }
+    if (files == 0) {
+        fprintf(stderr, "usage: telemetry_summary [--csv] FILE...\n");
+        return 2;
+    }
+    std::vector<BuildSummary*> order;
+    for (auto& kv : builds) order.push_back(&kv.second);
+    std::sort(order.begin(), order.end(), [](const BuildSummary* a, const BuildSummary* b) { return a->firstStart < b->firstStart; });
+
+    if (csv) printf("build,runs,hours,p50_ms,p95_ms,p99_ms,max_ms,median_run_p95_ms,hitches_per_min,rock,bird,quit,peak_particles,peak_birds,peak_rain,rain_periods,score\n");
+    else printf("%-24s %6s %7s %7s %7s %7s %8s %8s %8s %5s %5s %5s %7s %6s %6s\n", "build", "runs", "hours", "p50", "p95", "p99",
+        "max", "run p95", "hitch/m", "rock", "bird", "quit", "partcl", "birds", "rain");
+    for (const BuildSummary* b : order) {
+        std::vector<float> p95 = b->runP95;
+        std::sort(p95.begin(), p95.end());
+        float p50ms = TelemetryPercentile(b->hist, b->frames, 0.50f, b->maxFrame);
+        float p95ms = TelemetryPercentile(b->hist, b->frames, 0.95f, b->maxFrame);
+        float p99ms = TelemetryPercentile(b->hist, b->frames, 0.99f, b->maxFrame);
+        double hitchesPerMin = b->seconds > 0.0 ? b->hitches / (b->seconds / 60.0) : 0.0;
+        double runs = b->runs;
+        if (csv) {
+            printf("\"%s\",%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%.0f,%.0f,%.0f,%.2f,%.1f\n", b->build.c_str(), b->runs,
+                b->seconds / 3600.0, p50ms, p95ms, p99ms, b->maxFrame, p95[p95.size() / 2], hitchesPerMin,
+                b->deaths[DEATH_ROCK], b->deaths[DEATH_BIRD], b->deaths[DEATH_NONE], b->peakParticles / runs,
+                b->peakBirds / runs, b->peakRainDrops / runs, b->rainPeriods / runs, b->score / runs);
+        } else {
+            printf("%-24s %6d %7.2f %7.2f %7.2f %7.2f %8.1f %8.2f %8.2f %4.0f%% %4.0f%% %4.0f%% %7.0f %6.1f %6.0f\n", b->build.c_str(),
+                b->runs, b->seconds / 3600.0, p50ms, p95ms, p99ms, b->maxFrame, p95[p95.size() / 2], hitchesPerMin,
+                100.0 * b->deaths[DEATH_ROCK] / runs, 100.0 * b->deaths[DEATH_BIRD] / runs, 100.0 * b->deaths[DEATH_NONE] / runs,
+                b->peakParticles / runs, b->peakBirds / runs, b->peakRainDrops / runs);
+        }
+    }
+    if (skipped > 0) fprintf(stderr, "%lld records of another layout skipped\n", skipped);
+    return 0;
+}